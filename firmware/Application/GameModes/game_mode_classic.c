@@ -4,15 +4,18 @@
 
 #include "game_mode_classic.h"
 
+#include <stdlib.h>
 #include <string.h>
-#include <math.h>
 #include "ws2812b_api.h"
 #include "lcd_api.h"
 #include "debug_api.h"
-#include "heap_api.h"
 #include "framework_config.h"
 #include "math_utils.h"
 #include "message.h"
+#include "timestamp.h"
+#include "trace_log.h"
+#include "results_log.h"
+#include "accuracy_score.h"
 
 /**********************************************************************************************************************
  * Private definitions and macros
@@ -20,18 +23,16 @@
 
 #define DEBUG_GAME_MODE_CLASSIC
 
+/// Histogram bin widths, reaction times beyond 128 bins (~1 s) share the last bin
+#define ACCURACY_BIN_WIDTH 1
+#define REACTION_TIME_BIN_WIDTH_US 8000
+#define MEDIAN_PERCENTILE 50
+#define HIGH_PERCENTILE 95
+
 /**********************************************************************************************************************
  * Private typedef
  *********************************************************************************************************************/
 
-typedef struct sGameModeClassicData {
-    uint8_t attempt;
-    uint16_t target_distance;
-    uint8_t current_accuracy;
-    uint16_t current_reaction_time;
-    uint16_t average_accuracy;
-    uint16_t average_reaction_time;
-} sGameModeClassicData_t;
 
 /**********************************************************************************************************************
  * Private constants
@@ -80,17 +81,22 @@ bool Game_Mode_Classic_Start (void *context) {
     }
 
     if (game_mode->game_mode_data == NULL) {
-        game_mode->game_mode_data = Heap_API_Calloc(1 ,sizeof(sGameModeClassicData_t));
-    }
+        game_mode->game_mode_data = Session_Arena_Alloc(game_mode->session_arena, sizeof(sGameModeClassicData_t));
 
-    if (game_mode->game_mode_data == NULL) {
-        return false;
+        if (game_mode->game_mode_data == NULL) {
+            return false;
+        }
+
+        sGameModeClassicData_t *new_data = (sGameModeClassicData_t*) game_mode->game_mode_data;
+
+        Session_Stats_Init(&new_data->accuracy_stats, ACCURACY_BIN_WIDTH);
+        Session_Stats_Init(&new_data->reaction_time_stats, REACTION_TIME_BIN_WIDTH_US);
     }
 
     sGameModeClassicData_t *data = (sGameModeClassicData_t*) game_mode->game_mode_data;
 
     if (g_active_modules_index == NULL) {
-        g_active_modules_index = Heap_API_Calloc(game_mode->difficulty, sizeof(eModule_t));
+        g_active_modules_index = Session_Arena_Alloc(game_mode->session_arena, game_mode->difficulty * sizeof(eModule_t));
     }
     
     if (g_active_modules_index == NULL) {
@@ -118,6 +124,11 @@ bool Game_Mode_Classic_Start (void *context) {
     while (active_modules > 0) {
         uint32_t module_index = Math_Utils_RandomRange(0, eModule_Last);
 
+        // Active modules are kept as a set, every draw has to light a different module
+        if (Reaction_Test_App_GetModuleState(module_index) != eModuleState_Default) {
+            continue;
+        }
+
         if (!Reaction_Test_App_SetRandomTargetPossition(module_index)) {
             continue;
         }
@@ -132,12 +143,6 @@ bool Game_Mode_Classic_Start (void *context) {
             continue;
         }
 
-        if (!Reaction_Test_WaitForClear(module_index)) {
-            Reaction_Test_HandleGameError(eGameError_ClearStripTimeout);
-
-            return false;
-        }
-
         uint32_t start_delay = Math_Utils_RandomRange(MIN_START_DELAY, MAX_START_DELAY);
 
         if (!Reaction_Test_App_StartDelayTimer(module_index, start_delay)) {
@@ -162,30 +167,34 @@ void Game_Mode_Classic_Process (void *context) {
         return;
     }
 
-    data->current_reaction_time = (game_mode->end_time - game_mode->start_time);
+    data->current_reaction_time = Timestamp_ElapsedUs(game_mode->start_time, game_mode->end_time);
 
     uint32_t spacial_error = abs(data->target_distance - game_mode->registerd_distance);
 
-    if (spacial_error > DEFAULT_DISTANCE_THRESHOLD_MM) {
-        data->current_accuracy = exp(-(pow((spacial_error - DEFAULT_DISTANCE_THRESHOLD_MM), 2)) / pow((2 * ACCURACY_SIGMA), 2)) * 100;
-    } else {
-        data->current_accuracy = 100;
-    }
+    data->current_accuracy = Accuracy_Score_Get(spacial_error);
 
-    data->average_accuracy += data->current_accuracy;
-    data->average_reaction_time += data->current_reaction_time;
+    Session_Stats_Add(&data->accuracy_stats, data->current_accuracy);
+    Session_Stats_Add(&data->reaction_time_stats, data->current_reaction_time);
+
+#if defined(USE_RESULTS_LOG) && (RESULTS_LOG_TRIALS == true)
+    sResultsLogTrial_t trial = {
+        .reaction_time = data->current_reaction_time,
+        .target_distance = data->target_distance,
+        .registered_distance = game_mode->registerd_distance,
+        .accuracy = data->current_accuracy,
+        .attempt = data->attempt
+    };
+
+    Results_Log_AppendTrial(&trial);
+#endif
 
-    char uart_message[UART_MESSAGE_SIZE];
     char lcd_message[LCD_MESSAGE_SIZE + 1];
 
     sMessage_t message = {0};
 
-    snprintf(uart_message, UART_MESSAGE_SIZE, "Time: %d ms, Target: %d mm, Reg: %d mm, Acc: %d\n", data->current_reaction_time, data->target_distance, game_mode->registerd_distance, data->current_accuracy);
-    message.data = uart_message;
-
-    Reaction_Test_App_DisplayUart(message);
+    TRACE_LOG(eTraceLogId_Attempt, data->current_reaction_time / 1000, data->current_reaction_time % 1000, data->target_distance, game_mode->registerd_distance, data->current_accuracy);
 
-    snprintf(lcd_message, LCD_MESSAGE_SIZE + 1, "Time: %d ms", data->current_reaction_time);
+    snprintf(lcd_message, LCD_MESSAGE_SIZE + 1, "Time: %lu.%lu ms", data->current_reaction_time / 1000, (data->current_reaction_time % 1000) / 100);
     message.data = lcd_message;
     message.size = strlen(message.data);
 
@@ -225,33 +234,56 @@ void Game_Mode_Classic_Stop (void *context) {
         return;
     }
 
-    data->average_accuracy /= game_mode->total_attempts;
-    data->average_reaction_time /= game_mode->total_attempts;
+    sSessionStats_t *time_stats = &data->reaction_time_stats;
+    sSessionStats_t *accuracy_stats = &data->accuracy_stats;
+
+    uint32_t average_reaction_time = Session_Stats_GetMean(time_stats);
+    uint32_t reaction_time_deviation = Session_Stats_GetStdDev(time_stats);
+    uint32_t average_accuracy = Session_Stats_GetMean(accuracy_stats);
+
+#ifdef USE_RESULTS_LOG
+    sResultsLogSession_t session = {
+        .mean_reaction_time = average_reaction_time,
+        .reaction_time_deviation = reaction_time_deviation,
+        .median_reaction_time = Session_Stats_GetPercentile(time_stats, MEDIAN_PERCENTILE),
+        .p95_reaction_time = Session_Stats_GetPercentile(time_stats, HIGH_PERCENTILE),
+        .trials = time_stats->count,
+        .average_accuracy = average_accuracy,
+        .difficulty = game_mode->difficulty
+    };
+
+    Results_Log_AppendSession(&session);
+#endif
 
     char uart_message[UART_MESSAGE_SIZE];
     char lcd_message[LCD_MESSAGE_SIZE + 1];
 
     sMessage_t message = {0};
 
-    snprintf(uart_message, UART_MESSAGE_SIZE, "Average reaction time: %d ms\n", data->average_reaction_time);
+    snprintf(uart_message, UART_MESSAGE_SIZE, "Reaction time: %lu trials, avg %lu.%03lu ms, sd %lu.%03lu ms\n", time_stats->count, average_reaction_time / 1000, average_reaction_time % 1000, reaction_time_deviation / 1000, reaction_time_deviation % 1000);
+    message.data = uart_message;
+
+    Reaction_Test_App_DisplayUart(message);
+
+    snprintf(uart_message, UART_MESSAGE_SIZE, "Reaction time ms: min %lu, med %lu, p95 %lu, max %lu\n", time_stats->min / 1000, Session_Stats_GetPercentile(time_stats, MEDIAN_PERCENTILE) / 1000, Session_Stats_GetPercentile(time_stats, HIGH_PERCENTILE) / 1000, time_stats->max / 1000);
     message.data = uart_message;
 
     Reaction_Test_App_DisplayUart(message);
 
-    snprintf(uart_message, UART_MESSAGE_SIZE, "Average accuracy: %d\n", data->average_accuracy);
+    snprintf(uart_message, UART_MESSAGE_SIZE, "Accuracy: avg %lu, sd %lu, min %lu, median %lu, max %lu\n", average_accuracy, Session_Stats_GetStdDev(accuracy_stats), accuracy_stats->min, Session_Stats_GetPercentile(accuracy_stats, MEDIAN_PERCENTILE), accuracy_stats->max);
     message.data = uart_message;
 
     Reaction_Test_App_DisplayUart(message);
 
-    LCD_API_Clear(eLcd_1);
+    Reaction_Test_App_ClearLcd();
 
-    snprintf(lcd_message, LCD_MESSAGE_SIZE + 1, "Avg time %4dms", data->average_reaction_time);
+    snprintf(lcd_message, LCD_MESSAGE_SIZE + 1, "Avg time %4lums", average_reaction_time / 1000);
     message.data = lcd_message;
     message.size = strlen(message.data);
 
     Reaction_Test_App_DisplayLcd(message, eLcdRow_1, eLcdColumn_1, eLcdOption_None);
 
-    snprintf(lcd_message, LCD_MESSAGE_SIZE + 1, "Avg acc: %d", data->average_accuracy);
+    snprintf(lcd_message, LCD_MESSAGE_SIZE + 1, "Avg acc: %lu", average_accuracy);
     message.data = lcd_message;
     message.size = strlen(message.data);
 
@@ -267,15 +299,10 @@ void Game_Mode_Classic_Reset (void *context) {
 
     sGameModeClassic_t *game_mode = (sGameModeClassic_t *) context;
 
-    if (game_mode->game_mode_data != NULL) {
-        Heap_API_Free(game_mode->game_mode_data);
-        game_mode->game_mode_data = NULL;
-    }
-
-    if (g_active_modules_index != NULL) {
-        Heap_API_Free(g_active_modules_index);
-        g_active_modules_index = NULL;
-    }
+    // Memory stays in the session arena until the app resets it at session end
+    game_mode->game_mode_data = NULL;
+    g_active_modules_index = NULL;
+    g_active_modules_count = 0;
 
     return;
 }
@@ -7,22 +7,37 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "reaction_test_app.h"
+#include "session_arena.h"
+#include "session_stats.h"
 
 /**********************************************************************************************************************
  * Exported definitions and macros
  *********************************************************************************************************************/
 
+/// Session arena needed by one classic game: mode descriptor, game data and active module list
+#define GAME_MODE_CLASSIC_ARENA_SIZE (SESSION_ARENA_BLOCK(sizeof(sGameModeClassic_t)) + SESSION_ARENA_BLOCK(sizeof(sGameModeClassicData_t)) + SESSION_ARENA_BLOCK(eModule_Last * sizeof(eModule_t)))
+
 /**********************************************************************************************************************
  * Exported types
  *********************************************************************************************************************/
 
 /* clang-format off */
+typedef struct sGameModeClassicData {
+    uint8_t attempt;
+    uint16_t target_distance;
+    uint8_t current_accuracy;
+    uint32_t current_reaction_time;     // us
+    sSessionStats_t accuracy_stats;
+    sSessionStats_t reaction_time_stats;    // us
+} sGameModeClassicData_t;
+
 typedef struct sGameModeClassic {
     uint8_t difficulty;
     uint8_t total_attempts;
-    uint32_t start_time;
-    uint32_t end_time;
+    uint32_t start_time;    // Cue onset (us)
+    uint32_t end_time;      // Hand registration (us)
     uint16_t registerd_distance;
+    sSessionArena_t *session_arena;
     void *game_mode_data;
 } sGameModeClassic_t;
 /* clang-format on */
@@ -0,0 +1,82 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "accuracy_score.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/* clang-format off */
+/* Begin generated, Tools/gen_accuracy_lut.py --write */
+_Static_assert((ACCURACY_MAX == 100) && (ACCURACY_SIGMA == 100) && (DEFAULT_DISTANCE_THRESHOLD_MM == 10), "Regenerate with Tools/gen_accuracy_lut.py --write");
+
+/// Entry a is the first error past the threshold (mm) that scores below a
+static const uint32_t g_static_accuracy_bound_lut[ACCURACY_MAX + 1] = {
+    UINT32_MAX,
+    304, 280, 265, 254, 245, 238, 231, 225, 220, 215,
+    211, 206, 203, 199, 195, 192, 189, 186, 183, 180,
+    177, 175, 172, 169, 167, 165, 162, 160, 158, 156,
+    154, 151, 149, 147, 145, 143, 142, 140, 138, 136,
+    134, 132, 130, 129, 127, 125, 123, 122, 120, 118,
+    117, 115, 113, 112, 110, 108, 107, 105, 103, 102,
+    100, 98, 97, 95, 93, 92, 90, 88, 87, 85,
+    83, 82, 80, 78, 76, 75, 73, 71, 69, 67,
+    65, 64, 62, 60, 58, 55, 53, 51, 49, 46,
+    44, 41, 39, 36, 33, 29, 25, 21, 15, 1,
+};
+/* End generated */
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+/// Kept free of framework and RTOS headers, Tools/gen_accuracy_lut.py --check builds and runs it on the host
+uint8_t Accuracy_Score_Get (const uint32_t spacial_error) {
+    if (spacial_error <= DEFAULT_DISTANCE_THRESHOLD_MM) {
+        return ACCURACY_MAX;
+    }
+
+    uint32_t excess_error = spacial_error - DEFAULT_DISTANCE_THRESHOLD_MM;
+    uint8_t low = 0;
+    uint8_t high = ACCURACY_MAX;
+
+    // Highest score whose bound still lies beyond the error
+    while (low < high) {
+        uint8_t middle = (low + high + 1) / 2;
+
+        if (g_static_accuracy_bound_lut[middle] > excess_error) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    return low;
+}
@@ -0,0 +1,32 @@
+#ifndef SOURCE_APP_ACCURACY_SCORE_H_
+#define SOURCE_APP_ACCURACY_SCORE_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdint.h>
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/// Scoring curve: errors up to the threshold score ACCURACY_MAX, beyond it ACCURACY_MAX * exp(-e^2 / (2 * sigma^2))
+#define ACCURACY_MAX 100
+#define DEFAULT_DISTANCE_THRESHOLD_MM 10
+#define ACCURACY_SIGMA 100
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+uint8_t Accuracy_Score_Get (const uint32_t spacial_error);
+
+#endif /* SOURCE_APP_ACCURACY_SCORE_H_ */
@@ -0,0 +1,188 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "cue_scheduler.h"
+#include <stddef.h>
+#include "stm32f4xx_ll_tim.h"
+#include "debug_api.h"
+#include "timestamp.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_CUE_SCHEDULER
+
+/// Compare channel of the timestamp timer, so compare values are plain timestamps
+#define CUE_SCHEDULER_TIMER TIMESTAMP_TIMER
+#define CUE_SCHEDULER_CHANNEL LL_TIM_CHANNEL_CH1
+#define CUE_SCHEDULER_IRQ TIM5_IRQn
+/// Above the sensor EXTI, still within configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY for RTOS FromISR calls
+#define CUE_SCHEDULER_IRQ_PRIORITY 5
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_CUE_SCHEDULER
+CREATE_MODULE_NAME (CUE_SCHEDULER)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static bool g_is_initialized = false;
+static cue_scheduler_callback_t g_callback = NULL;
+static uint32_t g_cue_time[eModule_Last] = {0};
+/// Modules with a pending cue, the compare channel always holds the earliest of them
+static volatile uint32_t g_armed_modules = 0;
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static void Cue_Scheduler_Reload (void);
+
+void TIM5_IRQHandler (void);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+/// Runs in the timer interrupt or with it masked
+static void Cue_Scheduler_Reload (void) {
+    uint32_t armed = g_armed_modules;
+
+    CLEAR_BIT(CUE_SCHEDULER_TIMER->DIER, TIM_DIER_CC1IE);
+    WRITE_REG(CUE_SCHEDULER_TIMER->SR, ~TIM_SR_CC1IF);
+
+    if (armed == 0) {
+        return;
+    }
+
+    uint32_t now = Timestamp_GetUs();
+    uint32_t next_cue = g_cue_time[MODULE_MASK_LOWEST(armed)];
+
+    for (uint32_t pending = armed; pending != 0; pending &= pending - 1) {
+        uint32_t cue_time = g_cue_time[MODULE_MASK_LOWEST(pending)];
+
+        if ((int32_t) (cue_time - now) < (int32_t) (next_cue - now)) {
+            next_cue = cue_time;
+        }
+    }
+
+    WRITE_REG(CUE_SCHEDULER_TIMER->CCR1, next_cue);
+    SET_BIT(CUE_SCHEDULER_TIMER->DIER, TIM_DIER_CC1IE);
+
+    // Compare only matches on equality, a cue time already passed while loading fires at once
+    if ((int32_t) (Timestamp_GetUs() - next_cue) >= 0) {
+        WRITE_REG(CUE_SCHEDULER_TIMER->EGR, TIM_EGR_CC1G);
+    }
+
+    return;
+}
+
+void TIM5_IRQHandler (void) {
+    if (!READ_BIT(CUE_SCHEDULER_TIMER->DIER, TIM_DIER_CC1IE) || !READ_BIT(CUE_SCHEDULER_TIMER->SR, TIM_SR_CC1IF)) {
+        return;
+    }
+
+    uint32_t now = Timestamp_GetUs();
+    uint32_t due = 0;
+
+    for (uint32_t pending = g_armed_modules; pending != 0; pending &= pending - 1) {
+        eModule_t module = MODULE_MASK_LOWEST(pending);
+
+        if ((int32_t) (now - g_cue_time[module]) >= 0) {
+            due |= MODULE_MASK(module);
+        }
+    }
+
+    // Cues are one-shot, a module stays idle until it is armed again
+    g_armed_modules &= ~due;
+
+    Cue_Scheduler_Reload();
+
+    for (uint32_t pending = due; (pending != 0) && (g_callback != NULL); pending &= pending - 1) {
+        eModule_t module = MODULE_MASK_LOWEST(pending);
+
+        g_callback(module, g_cue_time[module]);
+    }
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Cue_Scheduler_Init (cue_scheduler_callback_t callback) {
+    if (g_is_initialized) {
+        return true;
+    }
+
+    if (callback == NULL) {
+        TRACE_ERR("Failed to init cue scheduler: Invalid callback\n");
+
+        return false;
+    }
+
+    g_callback = callback;
+
+    LL_TIM_OC_SetMode(CUE_SCHEDULER_TIMER, CUE_SCHEDULER_CHANNEL, LL_TIM_OCMODE_FROZEN);
+    CLEAR_BIT(CUE_SCHEDULER_TIMER->DIER, TIM_DIER_CC1IE);
+
+    NVIC_SetPriority(CUE_SCHEDULER_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), CUE_SCHEDULER_IRQ_PRIORITY, 0));
+    NVIC_EnableIRQ(CUE_SCHEDULER_IRQ);
+
+    g_is_initialized = true;
+
+    return true;
+}
+
+bool Cue_Scheduler_Arm (const eModule_t module, const uint32_t cue_time) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module)) {
+        return false;
+    }
+
+    NVIC_DisableIRQ(CUE_SCHEDULER_IRQ);
+
+    g_cue_time[module] = cue_time;
+    g_armed_modules |= MODULE_MASK(module);
+
+    Cue_Scheduler_Reload();
+
+    NVIC_EnableIRQ(CUE_SCHEDULER_IRQ);
+
+    return true;
+}
+
+bool Cue_Scheduler_Cancel (const eModule_t module) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module)) {
+        return false;
+    }
+
+    NVIC_DisableIRQ(CUE_SCHEDULER_IRQ);
+
+    if ((g_armed_modules & MODULE_MASK(module)) != 0) {
+        g_armed_modules &= ~MODULE_MASK(module);
+
+        Cue_Scheduler_Reload();
+    }
+
+    NVIC_EnableIRQ(CUE_SCHEDULER_IRQ);
+
+    return true;
+}
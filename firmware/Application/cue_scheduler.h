@@ -0,0 +1,34 @@
+#ifndef SOURCE_APP_CUE_SCHEDULER_H_
+#define SOURCE_APP_CUE_SCHEDULER_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "reaction_test_app.h"
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/// Called from the timer interrupt with the scheduled cue time (us)
+typedef void (*cue_scheduler_callback_t) (const eModule_t module, const uint32_t cue_time);
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Cue_Scheduler_Init (cue_scheduler_callback_t callback);
+bool Cue_Scheduler_Arm (const eModule_t module, const uint32_t cue_time);
+bool Cue_Scheduler_Cancel (const eModule_t module);
+
+#endif /* SOURCE_APP_CUE_SCHEDULER_H_ */
@@ -0,0 +1,163 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "i2c_bus.h"
+#include <stddef.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+
+#ifdef USE_I2C_MUX
+#include "stm32f4xx_ll_i2c.h"
+#include "timestamp.h"
+#endif
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_I2C_BUS
+
+#ifdef USE_I2C_MUX
+/// A one byte write takes about 200 us at 100 kHz
+#define I2C_BUS_WRITE_TIMEOUT_US 1000
+#endif
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_I2C_BUS
+CREATE_MODULE_NAME (I2C_BUS)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/* clang-format off */
+/// Priority inheritance lets a low priority LCD write finish quickly when a sensor read waits for it
+const static osMutexAttr_t g_i2c_bus_mutex_attributes = {
+    .name = "I2c_Bus_Mutex",
+    .attr_bits = osMutexPrioInherit,
+    .cb_mem = NULL,
+    .cb_size = 0
+};
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static osMutexId_t g_i2c_bus_mutex = NULL;
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+#ifdef USE_I2C_MUX
+static bool I2c_Bus_WaitFlag (uint32_t (*is_flag_set)(I2C_TypeDef *i2c), const uint32_t start_time);
+static bool I2c_Bus_SendByte (const uint8_t address, const uint8_t data, const uint32_t start_time);
+#endif
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+#ifdef USE_I2C_MUX
+/// Fails on a timeout or when the addressed device did not acknowledge
+static bool I2c_Bus_WaitFlag (uint32_t (*is_flag_set)(I2C_TypeDef *i2c), const uint32_t start_time) {
+    while (!is_flag_set(I2C1)) {
+        if (LL_I2C_IsActiveFlag_AF(I2C1) || (Timestamp_ElapsedUs(start_time, Timestamp_GetUs()) > I2C_BUS_WRITE_TIMEOUT_US)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Address and data phase of a write, the caller generates the start and stop conditions
+static bool I2c_Bus_SendByte (const uint8_t address, const uint8_t data, const uint32_t start_time) {
+    if (!I2c_Bus_WaitFlag(LL_I2C_IsActiveFlag_SB, start_time)) {
+        return false;
+    }
+
+    LL_I2C_TransmitData8(I2C1, (uint8_t) (address << 1));
+
+    if (!I2c_Bus_WaitFlag(LL_I2C_IsActiveFlag_ADDR, start_time)) {
+        return false;
+    }
+
+    LL_I2C_ClearFlag_ADDR(I2C1);
+    LL_I2C_TransmitData8(I2C1, data);
+
+    return I2c_Bus_WaitFlag(LL_I2C_IsActiveFlag_BTF, start_time);
+}
+#endif
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+/// VL53L0X sensors and the PCF8574 LCD share I2C1, every framework call on either goes through this lock
+bool I2c_Bus_Init (void) {
+    if (g_i2c_bus_mutex != NULL) {
+        return true;
+    }
+
+    g_i2c_bus_mutex = osMutexNew(&g_i2c_bus_mutex_attributes);
+
+    if (g_i2c_bus_mutex == NULL) {
+        TRACE_ERR("Failed to create I2C bus mutex\n");
+
+        return false;
+    }
+
+    return true;
+}
+
+void I2c_Bus_Lock (void) {
+    osMutexAcquire(g_i2c_bus_mutex, osWaitForever);
+
+    return;
+}
+
+void I2c_Bus_Unlock (void) {
+    osMutexRelease(g_i2c_bus_mutex);
+
+    return;
+}
+
+#ifdef USE_I2C_MUX
+/// Polled write for devices the framework has no driver for, the caller holds the lock so the framework transfer is idle
+bool I2c_Bus_WriteByte (const uint8_t address, const uint8_t data) {
+    uint32_t start_time = Timestamp_GetUs();
+
+    while (LL_I2C_IsActiveFlag_BUSY(I2C1)) {
+        if (Timestamp_ElapsedUs(start_time, Timestamp_GetUs()) > I2C_BUS_WRITE_TIMEOUT_US) {
+            TRACE_ERR("Failed to write to [0x%02X]: Bus busy\n", address);
+
+            return false;
+        }
+    }
+
+    LL_I2C_GenerateStartCondition(I2C1);
+
+    bool is_written = I2c_Bus_SendByte(address, data, start_time);
+
+    LL_I2C_GenerateStopCondition(I2C1);
+    LL_I2C_ClearFlag_AF(I2C1);
+
+    if (!is_written) {
+        TRACE_ERR("Failed to write to [0x%02X]\n", address);
+    }
+
+    return is_written;
+}
+#endif
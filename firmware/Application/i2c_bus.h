@@ -0,0 +1,34 @@
+#ifndef SOURCE_APP_I2C_BUS_H_
+#define SOURCE_APP_I2C_BUS_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "framework_config.h"
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool I2c_Bus_Init (void);
+void I2c_Bus_Lock (void);
+void I2c_Bus_Unlock (void);
+#ifdef USE_I2C_MUX
+bool I2c_Bus_WriteByte (const uint8_t address, const uint8_t data);
+#endif
+
+#endif /* SOURCE_APP_I2C_BUS_H_ */
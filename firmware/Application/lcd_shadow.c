@@ -0,0 +1,292 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "lcd_shadow.h"
+#include <stddef.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "i2c_bus.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_LCD_SHADOW
+
+#define LCD_SHADOW_BLANK ' '
+/// Unchanged gaps this short are resent, a cursor move would cost as much
+#define LCD_SHADOW_MERGE_GAP 1
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_LCD_SHADOW
+CREATE_MODULE_NAME (LCD_SHADOW)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/* clang-format off */
+const static osMutexAttr_t g_lcd_shadow_mutex_attributes = {
+    .name = "Lcd_Shadow_Mutex",
+    .attr_bits = osMutexPrioInherit,
+    .cb_mem = NULL,
+    .cb_size = 0
+};
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static bool g_is_initialized = false;
+static eLcd_t g_lcd = eLcd_1;
+static lcd_shadow_callback_t g_callback = NULL;
+static osMutexId_t g_lcd_shadow_mutex = NULL;
+/// Set while sensor timing must not share the bus with LCD writes, pending changes wait for the release
+static volatile bool g_is_held = false;
+
+/// Content requested by the app, guarded by the mutex
+static char g_target[LCD_SHADOW_ROWS][LCD_SHADOW_COLUMNS];
+/// Content on the display, only touched by the flushing thread
+static char g_shadow[LCD_SHADOW_ROWS][LCD_SHADOW_COLUMNS];
+
+#ifdef ENABLE_BENCHMARK
+static volatile uint32_t g_requested_chars = 0;
+static volatile uint32_t g_sent_chars = 0;
+static volatile uint32_t g_cursor_moves = 0;
+#endif
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static void Lcd_Shadow_Notify (void);
+static bool Lcd_Shadow_SyncRow (const uint8_t row, const char *target);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static void Lcd_Shadow_Notify (void) {
+    if (g_callback != NULL) {
+        g_callback();
+    }
+
+    return;
+}
+
+/// Returns false when a hold stopped the pass, the rest of the diff stays pending
+static bool Lcd_Shadow_SyncRow (const uint8_t row, const char *target) {
+    uint8_t column = 0;
+
+    while (column < LCD_SHADOW_COLUMNS) {
+        if (target[column] == g_shadow[row][column]) {
+            column++;
+
+            continue;
+        }
+
+        uint8_t start = column;
+        uint8_t end = column + 1;
+
+        // Extend the run over changed characters and over gaps too short to be worth a cursor move
+        for (uint8_t next = end; next < LCD_SHADOW_COLUMNS; next++) {
+            if (target[next] != g_shadow[row][next]) {
+                end = next + 1;
+            } else if ((next - end) >= LCD_SHADOW_MERGE_GAP) {
+                break;
+            }
+        }
+
+        sMessage_t message = {.data = (char *) &target[start], .size = end - start};
+
+        // The bus is taken per run, so a waiting sensor read never sits behind a whole redraw
+        I2c_Bus_Lock();
+
+        if (g_is_held) {
+            I2c_Bus_Unlock();
+
+            return false;
+        }
+
+        bool is_printed = LCD_API_Print(g_lcd, &message, (eLcdRow_t) (eLcdRow_1 + row), (eLcdColumn_t) (eLcdColumn_1 + start), eLcdOption_None);
+
+        I2c_Bus_Unlock();
+
+        if (is_printed) {
+            memcpy(&g_shadow[row][start], &target[start], end - start);
+        } else {
+            TRACE_ERR("Failed to update LCD row [%d]\n", row);
+        }
+
+#ifdef ENABLE_BENCHMARK
+        g_sent_chars += end - start;
+        g_cursor_moves++;
+#endif
+
+        column = end;
+    }
+
+    return true;
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+/// The LCD must already be initialized, it is cleared once and then only written by Lcd_Shadow_Flush
+bool Lcd_Shadow_Init (const eLcd_t lcd, lcd_shadow_callback_t callback) {
+    if (g_is_initialized) {
+        return true;
+    }
+
+    if (callback == NULL) {
+        TRACE_ERR("Failed to init LCD shadow: Invalid callback\n");
+
+        return false;
+    }
+
+    g_lcd = lcd;
+    g_callback = callback;
+
+    I2c_Bus_Lock();
+
+    bool is_cleared = LCD_API_Clear(g_lcd);
+
+    I2c_Bus_Unlock();
+
+    if (!is_cleared) {
+        TRACE_ERR("Failed to init LCD shadow: LCD clear failed\n");
+
+        return false;
+    }
+
+    memset(g_target, LCD_SHADOW_BLANK, sizeof(g_target));
+    memset(g_shadow, LCD_SHADOW_BLANK, sizeof(g_shadow));
+
+    g_lcd_shadow_mutex = osMutexNew(&g_lcd_shadow_mutex_attributes);
+
+    if (g_lcd_shadow_mutex == NULL) {
+        TRACE_ERR("Failed to create LCD shadow mutex\n");
+
+        return false;
+    }
+
+    g_is_initialized = true;
+
+    return true;
+}
+
+bool Lcd_Shadow_Clear (void) {
+    if (!g_is_initialized) {
+        return false;
+    }
+
+    osMutexAcquire(g_lcd_shadow_mutex, osWaitForever);
+    memset(g_target, LCD_SHADOW_BLANK, sizeof(g_target));
+    osMutexRelease(g_lcd_shadow_mutex);
+
+#ifdef ENABLE_BENCHMARK
+    g_requested_chars += LCD_SHADOW_ROWS * LCD_SHADOW_COLUMNS;
+#endif
+
+    Lcd_Shadow_Notify();
+
+    return true;
+}
+
+bool Lcd_Shadow_Print (const sMessage_t *message, const eLcdRow_t row, const eLcdColumn_t column) {
+    if (!g_is_initialized || (message == NULL) || (message->data == NULL)) {
+        return false;
+    }
+
+    uint8_t row_index = row - eLcdRow_1;
+    uint8_t column_index = column - eLcdColumn_1;
+
+    if ((row_index >= LCD_SHADOW_ROWS) || (column_index >= LCD_SHADOW_COLUMNS)) {
+        TRACE_ERR("Failed to print on LCD: Position [%d, %d] out of range\n", row, column);
+
+        return false;
+    }
+
+    size_t size = message->size;
+
+    // Text past the end of the row is cut, like the display itself would
+    if (size > (size_t) (LCD_SHADOW_COLUMNS - column_index)) {
+        size = LCD_SHADOW_COLUMNS - column_index;
+    }
+
+    osMutexAcquire(g_lcd_shadow_mutex, osWaitForever);
+    memcpy(&g_target[row_index][column_index], message->data, size);
+    osMutexRelease(g_lcd_shadow_mutex);
+
+#ifdef ENABLE_BENCHMARK
+    g_requested_chars += size;
+#endif
+
+    Lcd_Shadow_Notify();
+
+    return true;
+}
+
+/// Stops LCD writes and returns once a write already on the bus has finished
+void Lcd_Shadow_Hold (void) {
+    g_is_held = true;
+
+    I2c_Bus_Lock();
+    I2c_Bus_Unlock();
+
+    return;
+}
+
+void Lcd_Shadow_Release (void) {
+    g_is_held = false;
+
+    if (g_is_initialized) {
+        Lcd_Shadow_Notify();
+    }
+
+    return;
+}
+
+/// Sends what changed since the last flush, runs on a single low priority thread
+void Lcd_Shadow_Flush (void) {
+    if (!g_is_initialized) {
+        return;
+    }
+
+    char target[LCD_SHADOW_ROWS][LCD_SHADOW_COLUMNS];
+
+    // Writers only wait for this copy, never for the bus
+    osMutexAcquire(g_lcd_shadow_mutex, osWaitForever);
+    memcpy(target, g_target, sizeof(target));
+    osMutexRelease(g_lcd_shadow_mutex);
+
+    for (uint8_t row = 0; row < LCD_SHADOW_ROWS; row++) {
+        if (!Lcd_Shadow_SyncRow(row, target[row])) {
+            break;
+        }
+    }
+
+    return;
+}
+
+#ifdef ENABLE_BENCHMARK
+void Lcd_Shadow_BenchmarkReport (void) {
+    TRACE_INFO("LCD: %lu chars requested, %lu sent in %lu cursor moves\n", g_requested_chars, g_sent_chars, g_cursor_moves);
+
+    return;
+}
+#endif
@@ -0,0 +1,45 @@
+#ifndef SOURCE_APP_LCD_SHADOW_H_
+#define SOURCE_APP_LCD_SHADOW_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "framework_config.h"
+#include "lcd_api.h"
+#include "message.h"
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+#define LCD_SHADOW_ROWS 2
+#define LCD_SHADOW_COLUMNS 16
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/// Called from the writing thread whenever the content changed or a hold was released
+typedef void (*lcd_shadow_callback_t) (void);
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Lcd_Shadow_Init (const eLcd_t lcd, lcd_shadow_callback_t callback);
+bool Lcd_Shadow_Clear (void);
+bool Lcd_Shadow_Print (const sMessage_t *message, const eLcdRow_t row, const eLcdColumn_t column);
+void Lcd_Shadow_Hold (void);
+void Lcd_Shadow_Release (void);
+void Lcd_Shadow_Flush (void);
+#ifdef ENABLE_BENCHMARK
+void Lcd_Shadow_BenchmarkReport (void);
+#endif
+
+#endif /* SOURCE_APP_LCD_SHADOW_H_ */
@@ -0,0 +1,444 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "led_compositor.h"
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "timestamp.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_LED_COMPOSITOR
+
+/// WS2812B line timing, one frame is every LED's bits followed by the latch reset
+#define WS2812B_BITS_PER_LED 24
+#define WS2812B_BIT_TIME_NS 1250
+#define WS2812B_RESET_TIME_US 50
+
+/// Brightness is folded into the palette, the driver is left at full scale
+#define LED_COMPOSITOR_DRIVER_BRIGHTNESS 255
+#define LED_CHANNEL_LEVELS 256
+
+#ifdef ENABLE_BENCHMARK
+/// Strip lengths the measured per LED encode cost is reported for, the fitted strip and the longest supported one
+#define LED_COMPOSITOR_BENCHMARK_LED_COUNTS {85, 300}
+#endif
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+typedef enum eLedFrame {
+    eLedFrame_First = 0,
+    eLedFrame_Off = eLedFrame_First,
+    eLedFrame_Solid,
+    eLedFrame_Segment,
+    eLedFrame_Last
+} eLedFrame_t;
+
+typedef struct sLedLayer {
+    bool is_enabled;
+    eLedColor_t color;
+    uint16_t start_led;
+    uint16_t end_led;
+} sLedLayer_t;
+
+/// Composed strip content, compared against the last rendered one to skip redundant transfers
+typedef struct sLedComposedFrame {
+    eLedFrame_t frame;
+    eLedColor_t color;
+    eLedColor_t segment_color;
+    uint16_t start_led;
+    uint16_t end_led;
+} sLedComposedFrame_t;
+
+typedef struct sLedCompositorDesc {
+    bool is_initialized;
+    bool is_shown;
+    bool is_transferring;
+    uint32_t show_time;
+    uint32_t show_latency_us;
+    uint32_t frame_time_us;
+    sLedLayer_t layers[eLedLayer_Last];
+    sLedComposedFrame_t rendered;
+    uint8_t channel_lut[LED_CHANNEL_LEVELS];
+    sLedColorRgb_t palette[eLedColor_Last];
+    sLedAnimationDesc_t animation;
+    sLedAnimationSolidColor_t solid_color;
+    sLedAnimationSegmentFill_t segment_fill;
+#ifdef ENABLE_BENCHMARK
+    uint32_t encoded_frames;
+    uint32_t encode_cycles;
+    uint32_t max_encode_cycles;
+#endif
+} sLedCompositorDesc_t;
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_LED_COMPOSITOR
+CREATE_MODULE_NAME (LED_COMPOSITOR)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/// Gamma corrected channel levels, folded by the compiler from WS2812B_GAMMA
+#define LED_GAMMA(x) ((uint8_t) ((__builtin_pow((x) / 255.0, WS2812B_GAMMA) * 255.0) + 0.5))
+#define LED_GAMMA_4(x) LED_GAMMA(x), LED_GAMMA((x) + 1), LED_GAMMA((x) + 2), LED_GAMMA((x) + 3)
+#define LED_GAMMA_16(x) LED_GAMMA_4(x), LED_GAMMA_4((x) + 4), LED_GAMMA_4((x) + 8), LED_GAMMA_4((x) + 12)
+#define LED_GAMMA_64(x) LED_GAMMA_16(x), LED_GAMMA_16((x) + 16), LED_GAMMA_16((x) + 32), LED_GAMMA_16((x) + 48)
+
+static const uint8_t g_static_led_gamma_lut[LED_CHANNEL_LEVELS] = {LED_GAMMA_64(0), LED_GAMMA_64(64), LED_GAMMA_64(128), LED_GAMMA_64(192)};
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static sLedCompositorDesc_t g_led_compositor_desc[eModule_Last] = {0};
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static bool Led_Compositor_IsCorrectModule (const eModule_t module);
+static void Led_Compositor_Compose (const sLedCompositorDesc_t *desc, sLedComposedFrame_t *composed);
+static bool Led_Compositor_IsSameFrame (const sLedComposedFrame_t *first, const sLedComposedFrame_t *second);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static bool Led_Compositor_IsCorrectModule (const eModule_t module) {
+    return Reaction_Test_IsCorrectModule(module) && g_led_compositor_desc[module].is_initialized;
+}
+
+static void Led_Compositor_Compose (const sLedCompositorDesc_t *desc, sLedComposedFrame_t *composed) {
+    const sLedLayer_t *base = &desc->layers[eLedLayer_Base];
+    const sLedLayer_t *target = &desc->layers[eLedLayer_Target];
+    const sLedLayer_t *overlay = &desc->layers[eLedLayer_Overlay];
+
+    composed->frame = eLedFrame_Off;
+    composed->color = eLedColor_Off;
+    composed->segment_color = eLedColor_Off;
+    composed->start_led = 0;
+    composed->end_led = 0;
+
+    // Overlay covers the whole strip, the target segment is drawn over the base color
+    if (overlay->is_enabled) {
+        composed->frame = eLedFrame_Solid;
+        composed->color = overlay->color;
+
+        return;
+    }
+
+    if (target->is_enabled) {
+        composed->frame = eLedFrame_Segment;
+        composed->color = base->is_enabled ? base->color : eLedColor_Off;
+        composed->segment_color = target->color;
+        composed->start_led = target->start_led;
+        composed->end_led = target->end_led;
+
+        return;
+    }
+
+    if (base->is_enabled) {
+        composed->frame = eLedFrame_Solid;
+        composed->color = base->color;
+    }
+
+    return;
+}
+
+/// The animation buffer is read by the DMA until the frame has latched, a new frame must not be encoded before
+static void Led_Compositor_WaitTransfer (sLedCompositorDesc_t *desc) {
+    if (!desc->is_transferring) {
+        return;
+    }
+
+    uint32_t elapsed = Timestamp_ElapsedUs(desc->show_time, Timestamp_GetUs());
+
+    if (elapsed < desc->show_latency_us) {
+        osDelay(((desc->show_latency_us - elapsed) / 1000) + 1);
+    }
+
+    desc->is_transferring = false;
+
+    return;
+}
+
+static bool Led_Compositor_IsSameFrame (const sLedComposedFrame_t *first, const sLedComposedFrame_t *second) {
+    if (first->frame != second->frame) {
+        return false;
+    }
+
+    switch (first->frame) {
+        case eLedFrame_Solid: {
+            return (first->color == second->color);
+        }
+        case eLedFrame_Segment: {
+            return (first->color == second->color) && (first->segment_color == second->segment_color) && (first->start_led == second->start_led) && (first->end_led == second->end_led);
+        }
+        default: {
+            return true;
+        }
+    }
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Led_Compositor_Init (const eModule_t module, const eWs2812b_t strip, const uint8_t brightness) {
+    if (!Reaction_Test_IsCorrectModule(module)) {
+        TRACE_ERR("Failed to init [%d] compositor: Incorrect Module\n", module);
+
+        return false;
+    }
+
+    sLedCompositorDesc_t *desc = &g_led_compositor_desc[module];
+
+    // Brightness and gamma are resolved once per strip, channels are only looked up after this
+    for (uint32_t level = 0; level < LED_CHANNEL_LEVELS; level++) {
+        desc->channel_lut[level] = g_static_led_gamma_lut[((level * brightness) + 127U) / 255U];
+    }
+
+    for (eLedColor_t color = 0; color < eLedColor_Last; color++) {
+        sLedColorRgb_t rgb = LED_GetColorRgb(color);
+
+        desc->palette[color].r = desc->channel_lut[rgb.r];
+        desc->palette[color].g = desc->channel_lut[rgb.g];
+        desc->palette[color].b = desc->channel_lut[rgb.b];
+    }
+
+    desc->animation.device = strip;
+    desc->animation.brightness = LED_COMPOSITOR_DRIVER_BRIGHTNESS;
+    desc->frame_time_us = ((WS2812B_API_GetLedCount(strip) * WS2812B_BITS_PER_LED * WS2812B_BIT_TIME_NS) / 1000) + WS2812B_RESET_TIME_US;
+    desc->show_latency_us = desc->frame_time_us;
+    desc->is_transferring = false;
+
+    for (eLedLayer_t layer = eLedLayer_First; layer < eLedLayer_Last; layer++) {
+        desc->layers[layer].is_enabled = false;
+    }
+
+    desc->rendered.frame = eLedFrame_Off;
+    desc->is_shown = true;
+    desc->is_initialized = true;
+
+    return true;
+}
+
+bool Led_Compositor_SetBase (const eModule_t module, const eLedColor_t color) {
+    if (!Led_Compositor_IsCorrectModule(module)) {
+        return false;
+    }
+
+    g_led_compositor_desc[module].layers[eLedLayer_Base].is_enabled = true;
+    g_led_compositor_desc[module].layers[eLedLayer_Base].color = color;
+
+    return true;
+}
+
+bool Led_Compositor_SetTarget (const eModule_t module, const eLedColor_t color, const uint16_t start_led, const uint16_t end_led) {
+    if (!Led_Compositor_IsCorrectModule(module) || (start_led > end_led)) {
+        return false;
+    }
+
+    sLedLayer_t *target = &g_led_compositor_desc[module].layers[eLedLayer_Target];
+
+    target->is_enabled = true;
+    target->color = color;
+    target->start_led = start_led;
+    target->end_led = end_led;
+
+    return true;
+}
+
+bool Led_Compositor_SetOverlay (const eModule_t module, const eLedColor_t color) {
+    if (!Led_Compositor_IsCorrectModule(module)) {
+        return false;
+    }
+
+    g_led_compositor_desc[module].layers[eLedLayer_Overlay].is_enabled = true;
+    g_led_compositor_desc[module].layers[eLedLayer_Overlay].color = color;
+
+    return true;
+}
+
+bool Led_Compositor_ClearLayer (const eModule_t module, const eLedLayer_t layer) {
+    if (!Led_Compositor_IsCorrectModule(module) || (layer < eLedLayer_First) || (layer >= eLedLayer_Last)) {
+        return false;
+    }
+
+    g_led_compositor_desc[module].layers[layer].is_enabled = false;
+
+    return true;
+}
+
+bool Led_Compositor_Render (const eModule_t module) {
+    if (!Led_Compositor_IsCorrectModule(module)) {
+        return false;
+    }
+
+    sLedCompositorDesc_t *desc = &g_led_compositor_desc[module];
+    sLedComposedFrame_t composed;
+
+    Led_Compositor_Compose(desc, &composed);
+
+    if (Led_Compositor_IsSameFrame(&composed, &desc->rendered)) {
+        return true;
+    }
+
+    Led_Compositor_WaitTransfer(desc);
+
+    switch (composed.frame) {
+        case eLedFrame_Solid: {
+            desc->solid_color.rgb = desc->palette[composed.color];
+
+            desc->animation.animation = eLedAnimation_SolidColor;
+            desc->animation.data = &desc->solid_color;
+        } break;
+        case eLedFrame_Segment: {
+            desc->segment_fill.rgb_base = desc->palette[composed.color];
+            desc->segment_fill.rgb_segment = desc->palette[composed.segment_color];
+            desc->segment_fill.segment_start_led = composed.start_led;
+            desc->segment_fill.segment_end_led = composed.end_led;
+
+            desc->animation.animation = eLedAnimation_SegmentFill;
+            desc->animation.data = &desc->segment_fill;
+        } break;
+        default: {
+            if (!WS2812B_API_Reset(desc->animation.device)) {
+                return false;
+            }
+
+            desc->rendered = composed;
+            desc->is_shown = true;
+
+            return true;
+        }
+    }
+
+#ifdef ENABLE_BENCHMARK
+    uint32_t start = Timestamp_GetCycles();
+#endif
+
+    if (!WS2812B_API_AddAnimation(&desc->animation)) {
+        return false;
+    }
+
+#ifdef ENABLE_BENCHMARK
+    uint32_t cycles = Timestamp_GetCycles() - start;
+
+    desc->encoded_frames++;
+    desc->encode_cycles += cycles;
+
+    if (cycles > desc->max_encode_cycles) {
+        desc->max_encode_cycles = cycles;
+    }
+#endif
+
+    desc->rendered = composed;
+    desc->is_shown = false;
+
+    return true;
+}
+
+bool Led_Compositor_Show (const eModule_t module) {
+    if (!Led_Compositor_IsCorrectModule(module)) {
+        return false;
+    }
+
+    sLedCompositorDesc_t *desc = &g_led_compositor_desc[module];
+
+    if (desc->is_shown) {
+        return true;
+    }
+
+    uint32_t start_cycles = Timestamp_GetCycles();
+
+    desc->show_time = Timestamp_GetUs();
+
+    if (!WS2812B_API_Start(desc->animation.device)) {
+        return false;
+    }
+
+    // The DMA runs once the start call returns, the line timing then fixes when the strip latches
+    desc->show_latency_us = ((Timestamp_GetCycles() - start_cycles) / (SYSTEM_CLOCK_HZ / 1000000UL)) + desc->frame_time_us;
+    desc->is_shown = true;
+    desc->is_transferring = true;
+
+    return true;
+}
+
+bool Led_Compositor_Update (const eModule_t module) {
+    if (!Led_Compositor_Render(module)) {
+        return false;
+    }
+
+    return Led_Compositor_Show(module);
+}
+
+/// Time from the last Show call until the strip latched that frame
+uint32_t Led_Compositor_GetShowLatencyUs (const eModule_t module) {
+    if (!Led_Compositor_IsCorrectModule(module)) {
+        return 0;
+    }
+
+    return g_led_compositor_desc[module].show_latency_us;
+}
+
+bool Led_Compositor_Reset (const eModule_t module) {
+    if (!Led_Compositor_IsCorrectModule(module)) {
+        return false;
+    }
+
+    for (eLedLayer_t layer = eLedLayer_First; layer < eLedLayer_Last; layer++) {
+        g_led_compositor_desc[module].layers[layer].is_enabled = false;
+    }
+
+    // Always clear the strip, its content is unknown after an aborted transfer
+    g_led_compositor_desc[module].rendered.frame = eLedFrame_Last;
+
+    return Led_Compositor_Render(module);
+}
+
+#ifdef ENABLE_BENCHMARK
+void Led_Compositor_BenchmarkReport (void) {
+    const uint32_t benchmark_led_counts[] = LED_COMPOSITOR_BENCHMARK_LED_COUNTS;
+
+    for (eModule_t module = eModule_First; module < eModule_Last; module++) {
+        sLedCompositorDesc_t *desc = &g_led_compositor_desc[module];
+
+        if (!desc->is_initialized || (desc->encoded_frames == 0)) {
+            continue;
+        }
+
+        uint32_t average_cycles = desc->encode_cycles / desc->encoded_frames;
+        uint16_t led_count = WS2812B_API_GetLedCount(desc->animation.device);
+
+        TRACE_INFO("Strip [%d] %d LEDs: %lu frames, encode avg %lu cycles (%lu us, %lu cycles/LED), max %lu cycles\n", module, led_count, desc->encoded_frames, average_cycles, average_cycles / (SYSTEM_CLOCK_HZ / 1000000UL), (led_count != 0) ? (average_cycles / led_count) : 0, desc->max_encode_cycles);
+
+        if (led_count == 0) {
+            continue;
+        }
+
+        // Encoding is linear in the LED count, the wire time follows from the line timing
+        for (uint8_t index = 0; index < (sizeof(benchmark_led_counts) / sizeof(benchmark_led_counts[0])); index++) {
+            uint32_t encode_us = ((uint64_t) average_cycles * benchmark_led_counts[index]) / led_count / (SYSTEM_CLOCK_HZ / 1000000UL);
+            uint32_t wire_us = ((benchmark_led_counts[index] * WS2812B_BITS_PER_LED * WS2812B_BIT_TIME_NS) / 1000) + WS2812B_RESET_TIME_US;
+
+            TRACE_INFO("Strip [%d] at %lu LEDs: encode %lu us, transfer %lu us, %lu fps max\n", module, benchmark_led_counts[index], encode_us, wire_us, 1000000UL / (encode_us + wire_us));
+        }
+    }
+
+    return;
+}
+#endif
@@ -0,0 +1,54 @@
+#ifndef SOURCE_APP_LED_COMPOSITOR_H_
+#define SOURCE_APP_LED_COMPOSITOR_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ws2812b_api.h"
+#include "led_color.h"
+#include "framework_config.h"
+#include "reaction_test_app.h"
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/* clang-format off */
+typedef enum eLedLayer {
+    eLedLayer_First = 0,
+    eLedLayer_Base = eLedLayer_First,
+    eLedLayer_Target,
+    eLedLayer_Overlay,
+    eLedLayer_Last
+} eLedLayer_t;
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Led_Compositor_Init (const eModule_t module, const eWs2812b_t strip, const uint8_t brightness);
+bool Led_Compositor_SetBase (const eModule_t module, const eLedColor_t color);
+bool Led_Compositor_SetTarget (const eModule_t module, const eLedColor_t color, const uint16_t start_led, const uint16_t end_led);
+bool Led_Compositor_SetOverlay (const eModule_t module, const eLedColor_t color);
+bool Led_Compositor_ClearLayer (const eModule_t module, const eLedLayer_t layer);
+bool Led_Compositor_Render (const eModule_t module);
+bool Led_Compositor_Show (const eModule_t module);
+bool Led_Compositor_Update (const eModule_t module);
+uint32_t Led_Compositor_GetShowLatencyUs (const eModule_t module);
+bool Led_Compositor_Reset (const eModule_t module);
+#ifdef ENABLE_BENCHMARK
+void Led_Compositor_BenchmarkReport (void);
+#endif
+
+#endif /* SOURCE_APP_LED_COMPOSITOR_H_ */
@@ -15,6 +15,9 @@
 #include "reaction_test_app.h"
 #include "debug_api.h"
 #include "timer_driver.h"
+#include "timestamp.h"
+#include "trace_log.h"
+#include "results_log.h"
 
 /**********************************************************************************************************************
  * Private definitions and macros
@@ -22,6 +25,9 @@
 
 #define DEBUG_MAIN
 
+/// Left for framework allocations after boot, below this the next thread or queue may fail to create
+#define HEAP_HEADROOM 1024
+
 /**********************************************************************************************************************
  * Private typedef
  *********************************************************************************************************************/
@@ -126,8 +132,28 @@ int main (void) {
     Timer_Driver_InitAllTimers();
     Timer_Driver_Start(eTimerDriver_TIM10);
 
+    // Init TIM5 as free-running microsecond timestamp base
+    Timestamp_Init();
+
     CLI_APP_Init(eUartBaudrate_115200);
-    Reaction_Test_App_Init();
+
+#ifdef ENABLE_DEBUG
+    Trace_Log_Init();
+#endif
+
+#ifdef USE_RESULTS_LOG
+    if (!Results_Log_Init()) {
+        TRACE_ERR("Failed to init results log\n");
+    }
+#endif
+
+    if (!Reaction_Test_App_Init()) {
+        TRACE_ERR("Failed to init reaction test\n");
+    }
+
+    if (xPortGetFreeHeapSize() < HEAP_HEADROOM) {
+        TRACE_WRN("Heap headroom low: %u B free\n", xPortGetFreeHeapSize());
+    }
 
     TRACE_INFO("Start OK\n");
 
@@ -36,6 +36,8 @@
 
 /// -- DEBUG
 #define ENABLE_DEBUG                              // Enable debug messages
+#define ENABLE_TRACE_LOG                          // Send hot path debug messages as binary records on USART1 TX (PA9), decode with Tools/trace_decode.py
+//#define ENABLE_BENCHMARK                          // Enable timing benchmark reports on debug UART
 
 /// -- I²C bus
 #define USE_I2C1                                  // Enable I2C1 peripheral
@@ -65,6 +67,9 @@
 #define USE_VL53L0_XSHUT1                         // Enable VL53L0X sensor XSHUT
 #define USE_VL53L0X_2                             // Enable VL53L0X sensor
 #define USE_VL53L0_XSHUT2                         // Enable VL53L0X sensor XSHUT
+#define USE_VL53L0X_DATA_READY                    // Use VL53L0X GPIO1 data-ready EXTI instead of polling
+//#define USE_SIMULATED_SENSORS                     // Replace VL53L0X ranging with a scripted hand model (needs polling)
+//#define USE_I2C_MUX                               // Reach the sensors through a TCA9548A I2C mux, simulated with USE_SIMULATED_SENSORS
 
 /// -- Motors
 //#define USE_MOTOR_A                               // Enable Motor A
@@ -73,6 +78,9 @@
 /// -- LCD
 #define USE_LCD_1                                 // Enable LCD 1 (I2C) interface
 
+/// -- Results log
+#define USE_RESULTS_LOG                           // Keep session results in internal flash sectors 6-7
+
 //==============================================================================
 // SYSTEM TIMING
 //------------------------------------------------------------------------------
@@ -182,6 +190,8 @@
 
 #if defined(USE_WS2812B_1) || defined(USE_WS2812B_2)
 #define USE_WS2812B
+/// Gamma applied to every color channel, the correction table is built from it at compile time
+#define WS2812B_GAMMA 2.2
 #endif
 
 #ifdef USE_WS2812B_1
@@ -215,6 +225,25 @@
 #define RANGING_PROFILE_VL53L0_2 eVl53l0xRangeProfile_LongRange
 #endif
 
+#ifdef USE_I2C_MUX
+/// TCA9548A address with A0-A2 tied low
+#define I2C_MUX_ADDRESS 0x70
+#endif
+
+//==============================================================================
+// REACTION MODULES CONFIGURATION
+//------------------------------------------------------------------------------
+/// One entry per sensor and LED strip pair, up to 16. Enable the matching USE_VL53L0X_x and USE_WS2812B_x drivers above.
+/// X(id, vl53l0x, ws2812b, data_ready_port, data_ready_pin, mux_channel), data-ready pins need distinct pin numbers (EXTI lines)
+/// mux_channel (0-7) is the TCA9548A channel the sensor sits on, only used with USE_I2C_MUX
+/// EXTI lines 0 and 1 belong to the framework IO driver, data-ready pins use line 2 and up (see luxio.ioc)
+
+/* clang-format off */
+#define REACTION_MODULE_LIST(X)                                  \
+    X(1, eVl53l0x_1, eWs2812b_1, C, 2, 0)                        \
+    X(2, eVl53l0x_2, eWs2812b_2, C, 3, 1)
+/* clang-format on */
+
 //==============================================================================
 // MOTOR CONFIGURATION
 //------------------------------------------------------------------------------
@@ -253,4 +282,13 @@
 #define USE_LCD
 #endif
 
+//==============================================================================
+// RESULTS LOG CONFIGURATION
+//------------------------------------------------------------------------------
+
+#ifdef USE_RESULTS_LOG
+/// Log every trial next to the session summaries
+#define RESULTS_LOG_TRIALS true
+#endif
+
 #endif /* FRAMEWORK_UTILITY_EXAMPLE_CONFIG_H_ */
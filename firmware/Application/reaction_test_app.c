@@ -4,18 +4,33 @@
 
 #include "reaction_test_app.h"
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "cmsis_os2.h"
+#ifdef ENABLE_BENCHMARK
+#include "FreeRTOS.h"
+#endif
 #include "vl53l0xv2_api.h"
 #include "ws2812b_api.h"
 #include "io_api.h"
-#include "heap_api.h"
 #include "debug_api.h"
 #include "led_color.h"
 #include "math_utils.h"
 #include "message.h"
 #include "framework_config.h"
+#include "sensor_exti.h"
+#include "sensor_sim.h"
+#include "cue_scheduler.h"
+#include "led_compositor.h"
+#include "timestamp.h"
+#include "trace_log.h"
+#include "results_log.h"
+#include "lcd_shadow.h"
+#include "i2c_bus.h"
+#include "sensor_mux.h"
+#include "ui_task.h"
 
 #include "game_mode_classic.h"
 
@@ -30,17 +45,56 @@
 
 #define SINGLE_SEGMENT_LENGTH_UM 16670
 #define DEFAULT_LED_BRIGHTNESS 192
+#define DEFAULT_BASE_COLOR eLedColor_Blue
+#define DEFAULT_TARGET_COLOR eLedColor_Yellow
 #define DEFAULT_GET_DISTANCE_TIMEOUT 100
+/// Polled fetches only pick up finished samples, so one sensor never waits out another's conversion
+#define POLL_GET_DISTANCE_TIMEOUT 1
 #define WAIT_CLEAR_TIME 3000
+#define CLEAR_CONFIRM_SAMPLES 3
+/// Distance reported for a failed range measurement, neither clear nor a hit
+#define INVALID_DISTANCE_MM 0
 #define ERROR_LED_COLOR eLedColor_Red
-#define DEFAULT_MEASURE_TIMEOUT_FLAG 0x04U
+/// Error feedback blinks the overlay for ERROR_BLINK_TOGGLES * ERROR_BLINK_PERIOD (ms), odd so it starts lit and ends clear
+#define ERROR_BLINK_PERIOD 250
+#define ERROR_BLINK_TOGGLES 11
 #define WAIT_BETWEEN_ATTEMPTS 3000
+#define EVENT_QUEUE_SIZE 16
+
+#ifdef USE_I2C_MUX
+/// TCA9548A control byte with every channel enabled
+#define I2C_MUX_ALL_CHANNELS 0xFF
+#endif
+
+/// Reaction test thread flags, one cue bit per module so simultaneous delay timers never merge
+#define CUE_THREAD_FLAG(module) MODULE_MASK(module)
+#define CUE_THREAD_FLAGS ALL_MODULES_MASK
+#define MEASURE_TIMEOUT_THREAD_FLAG (1UL << eModule_Last)
+#define EVENT_QUEUE_THREAD_FLAG (1UL << (eModule_Last + 1))
+#define ERROR_BLINK_THREAD_FLAG (1UL << (eModule_Last + 2))
+#define DATA_READY_THREAD_FLAG (1UL << (eModule_Last + 3))
+#define ALL_THREAD_FLAGS (CUE_THREAD_FLAGS | MEASURE_TIMEOUT_THREAD_FLAG | EVENT_QUEUE_THREAD_FLAG | ERROR_BLINK_THREAD_FLAG | DATA_READY_THREAD_FLAG)
+/// Measure state event wait (ms), sensors are polled on timeout without data-ready EXTI
+#ifdef USE_VL53L0X_DATA_READY
+#define MEASURE_EVENT_WAIT osWaitForever
+#else
+#define MEASURE_EVENT_WAIT 5
+#endif
+/// WS2812B frame timing, LEDs latch the new frame after the reset gap
+#ifdef ENABLE_BENCHMARK
+/// Cue onset jitter histogram, the last bucket collects everything at or above the target
+#define CUE_JITTER_BUCKET_US 10
+#define CUE_JITTER_BUCKETS 11
+#endif
 
 #define DEFAULT_ATTEMPTS 5
 #define DEFAULT_TARGET_LED_COUNT 5
 #define DEFAULT_DIFFICULTY 1
 #define DEFAULT_MEASURE_TIMEOUT 10000
 
+/// Largest session arena footprint of the registered game modes
+#define SESSION_ARENA_SIZE GAME_MODE_CLASSIC_ARENA_SIZE
+
 /**********************************************************************************************************************
  * Private typedef
  *********************************************************************************************************************/
@@ -49,13 +103,26 @@ typedef enum eReactionTestState {
     eReactionTestState_First = 0,
     eReactionTestState_Off = eReactionTestState_First,
     eReactionTestState_Init,
+    eReactionTestState_Idle,
     eReactionTestState_Start,
+    eReactionTestState_WaitClear,
     eReactionTestState_Measure,
     eReactionTestState_Process,
     eReactionTestState_End,
+    eReactionTestState_Pause,
     eReactionTestState_Last
 } eReactionTestState_t;
 
+typedef enum eReactionTestEvent {
+    eReactionTestEvent_First = 0,
+    eReactionTestEvent_DataReady = eReactionTestEvent_First,
+    eReactionTestEvent_MeasureTimeout,
+    eReactionTestEvent_StartStop,
+    eReactionTestEvent_PauseElapsed,
+    eReactionTestEvent_ClearTimeout,
+    eReactionTestEvent_Last
+} eReactionTestEvent_t;
+
 typedef enum eGameMode {
     eGameMode_First = 0,
     eGameMode_Classic = eGameMode_First,
@@ -65,7 +132,6 @@ typedef enum eGameMode {
 typedef struct sReactionModuleDesc {
     eVl53l0x_t vl53l0x;
     eWs2812b_t ws2812b;
-    osTimerAttr_t segment_timer_attributes;
     eLedColor_t base_color;
     eLedColor_t target_color;
     uint8_t led_brightness;
@@ -74,19 +140,35 @@ typedef struct sReactionModuleDesc {
 typedef struct sReactionModuleDynamicDesc {
     eModule_t module;
     sModuleState_t state;
-    osTimerId_t segment_timer;
-    sLedAnimationSolidColor_t led_solid_color;
-    sLedAnimationSegmentFill_t led_segment_fill;
+    uint16_t target_start_led;
+    uint16_t target_end_led;
     uint16_t total_led_count;
     uint8_t target_led_count;
     uint16_t led_strip_length;
     uint16_t target_distance;
+    uint8_t clear_samples;
+    uint32_t cue_delay;
+    uint32_t cue_latency_us;
+    uint32_t cue_scheduled_time;
     uint32_t start_time;
     uint32_t end_time;
     uint16_t registerd_distance;
-    uint32_t timer_event_flag;
 } sReactionTestDynamicDesc_t;
 
+typedef struct sReactionTestEvent {
+    eReactionTestEvent_t event;
+    eModule_t module;
+    uint32_t timestamp;
+} sReactionTestEvent_t;
+
+#ifdef ENABLE_BENCHMARK
+typedef struct sSampleRateBenchmark {
+    uint32_t samples;
+    uint32_t first_sample_time;
+    uint32_t last_sample_time;
+} sSampleRateBenchmark_t;
+#endif
+
 /**********************************************************************************************************************
  * Private constants
  *********************************************************************************************************************/
@@ -101,41 +183,72 @@ CREATE_MODULE_NAME_EMPTY
 const static osThreadAttr_t g_reaction_test_thread_attributes = {
     .name = "Reaction_Test_Thread",
     .stack_size = 256 * 12,
-    .priority = (osPriority_t) osPriorityNormal
+    .priority = (osPriority_t) osPriorityHigh
 };
 
-const static osEventFlagsAttr_t g_start_button_event_attributes = {
-    .name = "Start_Button_Event",
+const static osTimerAttr_t g_measure_timeout_timer_attributes = {
+    .name = "Measure_Timeout_Timer",
     .attr_bits = 0,
     .cb_mem = NULL,
     .cb_size = 0
 };
 
-const static osTimerAttr_t g_measure_timeout_timer_attributes = {
-    .name = "Measure_Timeout_Timer",
+const static osTimerAttr_t g_clear_timeout_timer_attributes = {
+    .name = "Clear_Timeout_Timer",
     .attr_bits = 0,
     .cb_mem = NULL,
     .cb_size = 0
 };
 
-const static sReactionTestDesc_t g_static_reaction_test_desc[eModule_Last] = {
-    [eModule_1] = {
-        .vl53l0x = eVl53l0x_1,
-        .ws2812b = eWs2812b_1,
-        .segment_timer_attributes = {.name = "Reaction_Module_1_Timer", .attr_bits = 0, .cb_mem = NULL, .cb_size = 0U},
-        .base_color = eLedColor_Blue,
-        .target_color = eLedColor_Yellow,
-        .led_brightness = DEFAULT_LED_BRIGHTNESS
+const static osTimerAttr_t g_pause_timer_attributes = {
+    .name = "Attempt_Pause_Timer",
+    .attr_bits = 0,
+    .cb_mem = NULL,
+    .cb_size = 0
+};
+
+const static osTimerAttr_t g_error_blink_timer_attributes = {
+    .name = "Error_Blink_Timer",
+    .attr_bits = 0,
+    .cb_mem = NULL,
+    .cb_size = 0
+};
+
+const static osMessageQueueAttr_t g_event_queue_attributes = {
+    .name = "Reaction_Test_Event_Queue",
+    .attr_bits = 0,
+    .cb_mem = NULL,
+    .cb_size = 0,
+    .mq_mem = NULL,
+    .mq_size = 0
+};
+
+static const char *g_static_game_error_text[eGameError_Last] = {
+    [eGameError_ClearStripTimeout] = "Strip not clear",
+    [eGameError_InvalidStart] = "Early start",
+    [eGameError_MeasureTimeout] = "Measure timeout"
+};
+
+#define REACTION_TEST_DESC(id, vl53l0x_id, ws2812b_id, port, pin, mux_channel) \
+    [eModule_##id] = {                                           \
+        .vl53l0x = vl53l0x_id,                                   \
+        .ws2812b = ws2812b_id,                                   \
+        .base_color = DEFAULT_BASE_COLOR,                        \
+        .target_color = DEFAULT_TARGET_COLOR,                    \
+        .led_brightness = DEFAULT_LED_BRIGHTNESS                 \
     },
-    [eModule_2] = {
-        .vl53l0x = eVl53l0x_2,
-        .ws2812b = eWs2812b_2,
-        .segment_timer_attributes = {.name = "Reaction_Module_2_Timer", .attr_bits = 0, .cb_mem = NULL, .cb_size = 0U},
-        .base_color = eLedColor_Blue,
-        .target_color = eLedColor_Yellow,
-        .led_brightness = DEFAULT_LED_BRIGHTNESS
-    }
+
+const static sReactionTestDesc_t g_static_reaction_test_desc[eModule_Last] = {
+    REACTION_MODULE_LIST(REACTION_TEST_DESC)
 };
+
+#ifdef USE_I2C_MUX
+#define REACTION_TEST_MUX_CHANNEL(id, vl53l0x, ws2812b, port, pin, mux_channel) [eModule_##id] = mux_channel,
+
+static const uint8_t g_static_mux_channel_lut[eModule_Last] = {
+    REACTION_MODULE_LIST(REACTION_TEST_MUX_CHANNEL)
+};
+#endif
 /* clang-format on */ 
 
 /**********************************************************************************************************************
@@ -145,46 +258,48 @@ const static sReactionTestDesc_t g_static_reaction_test_desc[eModule_Last] = {
 static bool g_is_initialized = false;
 static osThreadId_t g_reaction_test_thread_id = NULL;
 static osTimerId_t g_measure_timeout_timer = NULL;
-static osEventFlagsId_t g_start_button_event = NULL;
-
-static osEventFlagsId_t g_timer_flag = NULL;
+static osTimerId_t g_clear_timeout_timer = NULL;
+static osTimerId_t g_pause_timer = NULL;
+static osTimerId_t g_error_blink_timer = NULL;
+static osMessageQueueId_t g_event_queue = NULL;
 
 static eReactionTestState_t g_reaction_test_state = eReactionTestState_Off;
+static eReactionTestState_t g_pause_next_state = eReactionTestState_Init;
+static eGameError_t g_game_error = eGameError_Last;
+/// Next attempt is prepared while the pause between attempts runs, its cues count from the pause end
+static bool g_is_pause_overlapped = false;
+static uint32_t g_pause_end_time = 0;
+/// START pressed during the pause after a session, the new session starts once Init has reset the modules
+static bool g_is_start_pending = false;
+#ifdef USE_I2C_MUX
+static sSensorMux_t g_sensor_mux;
+#endif
+static uint8_t g_error_blink_toggles = 0;
 static eGameMode_t g_game_mode = eGameMode_Classic;
-static sGameModeInstance_t g_game_mode_instance;
-static sLedAnimationDesc_t g_led_animation = {.brightness = DEFAULT_LED_BRIGHTNESS};
+static uint64_t g_session_arena_buffer[(SESSION_ARENA_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+static sSessionArena_t g_session_arena = {.buffer = (uint8_t*) g_session_arena_buffer, .size = sizeof(g_session_arena_buffer), .used = 0};
+static sGameModeInstance_t g_game_mode_instance = {.session_arena = &g_session_arena};
 static sMessage_t g_message = {0};
 
-static eModule_t *g_active_modules;
-static uint8_t g_active_modules_count = 0;
+/// Active modules of the attempt and, per module state, the modules currently in it
+static uint32_t g_active_modules = 0;
+static uint32_t g_module_state_mask[eModuleState_Last] = {0};
+
+#ifdef USE_VL53L0X_DATA_READY
+/// Set from EXTI context per module, a bit stays set until the thread reads the sample
+static volatile uint32_t g_data_ready_modules = 0;
+static volatile uint32_t g_data_ready_time[eModule_Last] = {0};
+#endif
+
+#ifdef ENABLE_BENCHMARK
+static sSampleRateBenchmark_t g_sample_rate_benchmark[eModule_Last] = {0};
+static uint32_t g_cue_jitter_histogram[CUE_JITTER_BUCKETS] = {0};
+#endif
 
 static uint8_t g_difficulty = DEFAULT_DIFFICULTY;
 static uint8_t g_total_attempts = DEFAULT_ATTEMPTS;
 
-/* clang-format off */ 
-static sReactionTestDynamicDesc_t g_dynamic_reaction_test_desc[eModule_Last] = {
-    [eModule_1] = {
-        .state = eReactionTestState_Init,
-        .segment_timer = NULL,
-        .target_led_count = DEFAULT_TARGET_LED_COUNT,
-        .target_distance = 0,
-        .start_time = 0,
-        .end_time = 0,
-        .registerd_distance = 0,
-        .timer_event_flag = 0x02U
-    },
-    [eModule_2] = {
-        .state = eReactionTestState_Init,
-        .segment_timer = NULL,
-        .target_led_count = DEFAULT_TARGET_LED_COUNT,
-        .target_distance = 0,
-        .start_time = 0,
-        .end_time = 0,
-        .registerd_distance = 0,
-        .timer_event_flag = 0x02U
-    }
-};
-/* clang-format on */ 
+static sReactionTestDynamicDesc_t g_dynamic_reaction_test_desc[eModule_Last] = {0};
 
 /**********************************************************************************************************************
  * Exported variables and references
@@ -195,53 +310,103 @@ static sReactionTestDynamicDesc_t g_dynamic_reaction_test_desc[eModule_Last] = {
  *********************************************************************************************************************/
  
 static void Reaction_Test_Thread (void* arg);
+static void Reaction_Test_StartStopPressed (void);
+static void Reaction_Test_HandleEvent (const sReactionTestEvent_t *event);
+static void Reaction_Test_HandleThreadFlags (const uint32_t flags);
+static bool Reaction_Test_PostEvent (const sReactionTestEvent_t *event, const uint32_t timeout);
+static bool Reaction_Test_SetupGameMode (void);
+static void Reaction_Test_StartSession (void);
+static bool Reaction_Test_StartWaitClear (void);
+static bool Reaction_Test_ArmCues (void);
+static bool Reaction_Test_StartCues (const uint32_t cue_flags);
+#ifndef USE_VL53L0X_DATA_READY
+static void Reaction_Test_PollModules (void);
+#endif
+static void Reaction_Test_SetModuleState (const eModule_t module, const sModuleState_t state);
+static void Reaction_Test_CheckClear (void);
+static void Reaction_Test_CheckRegistered (void);
 static bool Reaction_Test_InitModules (void);
-static void Reaction_Test_DelayStartTimer (void *arg);
+static void Reaction_Test_CueDue (const eModule_t module, const uint32_t cue_time);
 static void Reaction_Test_MeasureTimeoutTimer (void *arg);
+static void Reaction_Test_ClearTimeoutTimer (void *arg);
+static void Reaction_Test_PauseTimer (void *arg);
+static void Reaction_Test_ErrorBlinkTimer (void *arg);
+static void Reaction_Test_StartErrorFeedback (const eGameError_t error);
+static void Reaction_Test_ToggleErrorFeedback (void);
+static void Reaction_Test_StopErrorFeedback (void);
 static sModuleState_t Reaction_Test_IsModuleClear (const eModule_t module);
+static void Reaction_Test_HandleSample (const eModule_t module, const uint32_t timestamp);
+static uint8_t Reaction_Test_OrderModules (const uint32_t modules, uint8_t *order);
+static bool Reaction_Test_SelectSensor (const eModule_t module);
+#ifdef USE_I2C_MUX
+static bool Reaction_Test_SelectMuxChannel (const uint8_t channel);
+#endif
+static bool Reaction_Test_GetDistance (const eModule_t module, const uint32_t timeout);
+static bool Reaction_Test_StartRanging (const eModule_t module);
+static bool Reaction_Test_StopRanging (const eModule_t module);
+#ifdef ENABLE_BENCHMARK
+static void Reaction_Test_BenchmarkSample (const eModule_t module, const uint32_t timestamp);
+static void Reaction_Test_BenchmarkReport (void);
+#endif
+#ifdef USE_VL53L0X_DATA_READY
+static void Reaction_Test_SensorDataReady (const eModule_t module, const uint32_t timestamp);
+#endif
 
 /**********************************************************************************************************************
  * Definitions of private functions
  *********************************************************************************************************************/
  
 static void Reaction_Test_Thread (void* arg) {
-    if (VL53L0X_API_InitAll()) {
-        if (LCD_API_InitAllLcd()) {
-            g_reaction_test_state = eReactionTestState_Init;
-        }
+    I2c_Bus_Lock();
+
+#ifdef USE_SIMULATED_SENSORS
+    bool is_bus_ready = Sensor_Sim_Init() && LCD_API_InitAllLcd();
+#elif defined(USE_I2C_MUX)
+    // The framework brings up every sensor at once, so all channels stay open until the first read selects one
+    bool is_bus_ready = I2c_Bus_WriteByte(I2C_MUX_ADDRESS, I2C_MUX_ALL_CHANNELS) && VL53L0X_API_InitAll() && LCD_API_InitAllLcd();
+#else
+    bool is_bus_ready = VL53L0X_API_InitAll() && LCD_API_InitAllLcd();
+#endif
+
+    I2c_Bus_Unlock();
+
+    if (is_bus_ready && Ui_Task_AttachLcd(LCD_DISPLAY)) {
+        g_reaction_test_state = eReactionTestState_Init;
     } else {
         TRACE_ERR("Failed to init\n");
     }
     
     while (true) {
-        if (g_reaction_test_state == eReactionTestState_Off) {
-            TRACE_ERR("Reaction Test Thread terminated\n");
-            osThreadTerminate(g_reaction_test_thread_id);
-        }
-
-        if (g_reaction_test_state != eReactionTestState_Init) {
-            if (osEventFlagsWait(g_start_button_event, STARTSTOP_TRIGGERED_EVENT, osFlagsWaitAny, 0U) == STARTSTOP_TRIGGERED_EVENT) {
-                TRACE_INFO("Stop reaction test\n");
-
-                g_reaction_test_state = eReactionTestState_Init;
-            }
-        }
-        
         switch (g_reaction_test_state) {
+            case eReactionTestState_Off: {
+                TRACE_ERR("Reaction Test Thread terminated\n");
+                osThreadTerminate(g_reaction_test_thread_id);
+            } break;
             case eReactionTestState_Init: {
-                if (osEventFlagsWait(g_timer_flag, DEFAULT_MEASURE_TIMEOUT_FLAG, osFlagsWaitAny, 0U) == DEFAULT_MEASURE_TIMEOUT_FLAG) {
-                    TRACE_ERR("Measure timeout\n");
-                    
-                    Reaction_Test_HandleGameError(eGameError_MeasureTimeout);
+                if (g_game_mode_instance.game_mode_reset != NULL) {
+                    g_game_mode_instance.game_mode_reset(g_game_mode_instance.game_mode_data);
                 }
 
-                if (g_game_mode_instance.game_mode_data != NULL) {
-                    Heap_API_Free(g_game_mode_instance.game_mode_data);
-                }
+                g_game_mode_instance.game_mode_data = NULL;
+                Session_Arena_Reset(&g_session_arena);
 
                 if (osTimerIsRunning(g_measure_timeout_timer)) {
                     osTimerStop(g_measure_timeout_timer);
                 }
+
+                if (osTimerIsRunning(g_clear_timeout_timer)) {
+                    osTimerStop(g_clear_timeout_timer);
+                }
+
+                if (osTimerIsRunning(g_pause_timer)) {
+                    osTimerStop(g_pause_timer);
+                }
+
+                Reaction_Test_StopErrorFeedback();
+
+                g_is_pause_overlapped = false;
+
+                Lcd_Shadow_Release();
                 
                 if (!Reaction_Test_InitModules()) {
                     //TRACE_ERR("Failed to init reaction test\n");
@@ -250,69 +415,59 @@ static void Reaction_Test_Thread (void* arg) {
 
                     break;
                 }
-                
-                LCD_API_Clear(LCD_DISPLAY);
 
-                g_message.data = "Reaction Test";
-                g_message.size = strlen(g_message.data);
+                osMessageQueueReset(g_event_queue);
+                osThreadFlagsClear(ALL_THREAD_FLAGS);
 
-                LCD_API_Print(LCD_DISPLAY, &g_message, eLcdRow_1, eLcdColumn_2, eLcdOption_None);
+#ifdef USE_VL53L0X_DATA_READY
+                __atomic_store_n(&g_data_ready_modules, 0, __ATOMIC_RELAXED);
+#endif
 
-                g_message.data = "- Press  START -";
-                g_message.size = strlen(g_message.data);
+#ifdef USE_RESULTS_LOG
+                // Nothing is measured until START, the flash can be programmed now
+                Results_Log_Resume();
+                Results_Log_Flush();
+#endif
 
-                LCD_API_Print(LCD_DISPLAY, &g_message, eLcdRow_2, eLcdColumn_1, eLcdOption_None);
+                Reaction_Test_App_ClearLcd();
 
-                if (osEventFlagsWait(g_start_button_event, STARTSTOP_TRIGGERED_EVENT, osFlagsWaitAny, osWaitForever) != STARTSTOP_TRIGGERED_EVENT) {
-                    TRACE_ERR("Failed to to receive start button flag\n");
-                    
-                    break;
-                }
+                if (g_game_error != eGameError_Last) {
+                    Reaction_Test_StartErrorFeedback(g_game_error);
 
-                srand(osKernelGetTickCount());
+                    g_game_error = eGameError_Last;
+                } else {
+                    g_message.data = "Reaction Test";
+                    g_message.size = strlen(g_message.data);
 
-                switch (g_game_mode) {
-                    case eGameMode_Classic: {
-                        sGameModeClassic_t *data = Heap_API_Calloc(1, sizeof(sGameModeClassic_t));
-                        
-                        if (data == NULL) {
-                            TRACE_ERR("Failed alloc memory for game mode data\n");
+                    Reaction_Test_App_DisplayLcd(g_message, eLcdRow_1, eLcdColumn_2, eLcdOption_None);
+                }
 
-                            g_reaction_test_state = eReactionTestState_Init;
-                            
-                            break;
-                        }
+                g_message.data = "- Press  START -";
+                g_message.size = strlen(g_message.data);
 
-                        data->difficulty = g_difficulty;
-                        data->total_attempts = g_total_attempts;
-
-                        g_game_mode_instance.game_mode_data = data;
-                        g_game_mode_instance.game_mode_start = Game_Mode_Classic_Start;
-                        g_game_mode_instance.game_mode_process = Game_Mode_Classic_Process;
-                        g_game_mode_instance.game_mode_is_restart = Game_Mode_Classic_IsRestart;
-                        g_game_mode_instance.game_mode_stop = Game_Mode_Classic_Stop;
-                        g_game_mode_instance.game_mode_reset = Game_Mode_Classic_Reset;
-                        g_game_mode_instance.get_active_modules = Game_Mode_Classic_GetActiveModules;
-                    } break;
-                    default: {
-                        g_reaction_test_state = eReactionTestState_Init;
-                        
-                        break;
-                    }
-                }
+                Reaction_Test_App_DisplayLcd(g_message, eLcdRow_2, eLcdColumn_1, eLcdOption_None);
 
-                TRACE_INFO("Start reaction test\n");
+                g_reaction_test_state = eReactionTestState_Idle;
 
-                g_reaction_test_state = eReactionTestState_Start;
-            }
+                if (g_is_start_pending) {
+                    g_is_start_pending = false;
+
+                    Reaction_Test_StartSession();
+                }
+            } break;
             case eReactionTestState_Start: {
                 if (!g_game_mode_instance.game_mode_start(g_game_mode_instance.game_mode_data)) {
+                    if (g_reaction_test_state == eReactionTestState_Start) {
+                        g_reaction_test_state = eReactionTestState_Init;
+                    }
+
                     break;
                 }
 
-                g_active_modules = g_game_mode_instance.get_active_modules(&g_active_modules_count);
+                uint8_t active_modules_count = 0;
+                eModule_t *active_modules = g_game_mode_instance.get_active_modules(&active_modules_count);
 
-                if (g_active_modules == NULL) {
+                if (active_modules == NULL) {
                     TRACE_ERR("Failed to get active modules\n");
 
                     g_reaction_test_state = eReactionTestState_Init;
@@ -320,85 +475,58 @@ static void Reaction_Test_Thread (void* arg) {
                     break;
                 }
 
-                if (!LCD_API_Clear(LCD_DISPLAY)) {
+                g_active_modules = 0;
+
+                for (uint8_t module = 0; module < active_modules_count; module++) {
+                    g_active_modules |= MODULE_MASK(active_modules[module]);
+                }
+
+                // Results of the previous attempt stay on the LCD through an overlapped pause
+                if (!g_is_pause_overlapped && !Reaction_Test_App_ClearLcd()) {
                     g_reaction_test_state = eReactionTestState_Init;
 
                     break;
                 }
 
                 if (g_reaction_test_state == eReactionTestState_Start) {
-                    g_reaction_test_state = eReactionTestState_Measure;
-                }
-            } break;
-            case eReactionTestState_Measure: {
-                uint8_t registered_modules = 0;
-
-                for (uint8_t module = 0; module < g_active_modules_count; module++) {
-                    if (g_dynamic_reaction_test_desc[g_active_modules[module]].state == eModuleState_Ready) {
-                        if (osEventFlagsWait(g_timer_flag, g_dynamic_reaction_test_desc[g_active_modules[module]].timer_event_flag, osFlagsWaitAny, 0U) == g_dynamic_reaction_test_desc[g_active_modules[module]].timer_event_flag) {
-                            if (!WS2812B_API_Start(g_static_reaction_test_desc[g_active_modules[module]].ws2812b)) {
-                                //TRACE_ERR("Failed to start animation on [%d] module\n", module);
-                        
-                                g_reaction_test_state = eReactionTestState_Init;
-                        
-                                return;
-                            }
-                        
-                            g_dynamic_reaction_test_desc[g_active_modules[module]].state = eModuleState_Measuring;
-                            g_dynamic_reaction_test_desc[g_active_modules[module]].start_time = osKernelGetTickCount();
-
-                            continue;
-                        }
-
-                        if (Reaction_Test_IsModuleClear(g_active_modules[module]) == eModuleState_Last) {
-                            Reaction_Test_HandleGameError(eGameError_InvalidStart);
-                            g_reaction_test_state = eReactionTestState_Init;
-                    
-                            break;
-                        }
-                    } 
-
-                    if (g_dynamic_reaction_test_desc[g_active_modules[module]].state != eModuleState_Measuring) {
-                        continue;
-                    }
+#ifdef ENABLE_BENCHMARK
+                    memset(g_sample_rate_benchmark, 0, sizeof(g_sample_rate_benchmark));
+#ifdef USE_I2C_MUX
+                    Sensor_Mux_ResetStats(&g_sensor_mux);
+#endif
+#endif
 
-                    if (!VL53L0X_API_GetDistance(g_static_reaction_test_desc[g_active_modules[module]].vl53l0x, &g_dynamic_reaction_test_desc[g_active_modules[module]].registerd_distance, DEFAULT_GET_DISTANCE_TIMEOUT)) {
-                        continue;
-                    }
+                    if (!Reaction_Test_StartWaitClear()) {
+                        g_reaction_test_state = eReactionTestState_Init;
 
-                    if (g_dynamic_reaction_test_desc[g_active_modules[module]].registerd_distance > g_dynamic_reaction_test_desc[g_active_modules[module]].led_strip_length) {
-                        continue;
+                        break;
                     }
 
-                    g_dynamic_reaction_test_desc[g_active_modules[module]].end_time = osKernelGetTickCount();
-                    g_dynamic_reaction_test_desc[g_active_modules[module]].state = eModuleState_Registered;
-
-                    WS2812B_API_Reset(g_static_reaction_test_desc[g_active_modules[module]].ws2812b);
-
-                    registered_modules++;
-                }
-
-                if (registered_modules != g_active_modules_count) {
-                    break;
+                    g_reaction_test_state = eReactionTestState_WaitClear;
                 }
-
-                g_reaction_test_state = eReactionTestState_Process;
             } break;
             case eReactionTestState_Process: {
                 osTimerStop(g_measure_timeout_timer);
 
-                for (uint8_t module = 0; module < g_active_modules_count; module++) {
-                    if (g_dynamic_reaction_test_desc[g_active_modules[module]].state != eModuleState_Registered) {
-                        continue;
-                    }
-                    
+                // Measure is over, the LCD may use the bus again
+                Lcd_Shadow_Release();
+
+#ifdef ENABLE_BENCHMARK
+                Reaction_Test_BenchmarkReport();
+#endif
+
+                Reaction_Test_App_ClearLcd();
+
+                for (uint32_t pending = g_active_modules & g_module_state_mask[eModuleState_Registered]; pending != 0; pending &= pending - 1) {
+                    eModule_t module = MODULE_MASK_LOWEST(pending);
+
                     switch (g_game_mode) {
                         case eGameMode_Classic: {
                             sGameModeClassic_t *data = (sGameModeClassic_t*) g_game_mode_instance.game_mode_data;
                             
-                            data->start_time = g_dynamic_reaction_test_desc[g_active_modules[module]].start_time;
-                            data->end_time = g_dynamic_reaction_test_desc[g_active_modules[module]].end_time;
-                            data->registerd_distance = g_dynamic_reaction_test_desc[g_active_modules[module]].registerd_distance;
+                            data->start_time = g_dynamic_reaction_test_desc[module].start_time;
+                            data->end_time = g_dynamic_reaction_test_desc[module].end_time;
+                            data->registerd_distance = g_dynamic_reaction_test_desc[module].registerd_distance;
                         } break;
                         default: {
                             g_reaction_test_state = eReactionTestState_Init;
@@ -408,6 +536,24 @@ static void Reaction_Test_Thread (void* arg) {
                     }
 
                     g_game_mode_instance.game_mode_process(g_game_mode_instance.game_mode_data);
+
+#ifdef USE_SIMULATED_SENSORS
+                    if (g_game_mode == eGameMode_Classic) {
+                        sGameModeClassic_t *data = (sGameModeClassic_t*) g_game_mode_instance.game_mode_data;
+                        sGameModeClassicData_t *classic_data = (sGameModeClassicData_t*) data->game_mode_data;
+
+                        Sensor_Sim_CheckTrial(module, data->registerd_distance, Timestamp_ElapsedUs(data->start_time, data->end_time), classic_data->current_accuracy);
+                    }
+#endif
+                }
+
+                // Sampling is over, waiting for a frame to latch no longer delays anyone
+                for (uint32_t pending = g_active_modules & g_module_state_mask[eModuleState_Registered]; pending != 0; pending &= pending - 1) {
+                    eModule_t module = MODULE_MASK_LOWEST(pending);
+
+                    if (!Led_Compositor_Reset(module)) {
+                        TRACE_ERR("Failed to clear [%d] module strip\n", module);
+                    }
                 }
 
                 if (g_reaction_test_state == eReactionTestState_Process) {
@@ -416,209 +562,952 @@ static void Reaction_Test_Thread (void* arg) {
             } break;
             case eReactionTestState_End: {
                 if (g_game_mode_instance.game_mode_is_restart(g_game_mode_instance.game_mode_data)) {
-                    g_reaction_test_state = eReactionTestState_Start;
+                    // Prepare the next attempt right away, its cues are armed once the pause is over
+                    g_pause_end_time = Timestamp_GetUs() + (WAIT_BETWEEN_ATTEMPTS * 1000UL);
+                    g_is_pause_overlapped = (osTimerStart(g_pause_timer, WAIT_BETWEEN_ATTEMPTS) == osOK);
+
+                    if (!g_is_pause_overlapped) {
+                        TRACE_ERR("Failed to start pause timer\n");
+                    }
 
-                    osDelay(WAIT_BETWEEN_ATTEMPTS);
+                    g_reaction_test_state = eReactionTestState_Start;
 
                     break;
-                } 
+                }
 
                 g_game_mode_instance.game_mode_stop(g_game_mode_instance.game_mode_data);
                 g_game_mode_instance.game_mode_reset(g_game_mode_instance.game_mode_data);
 
-                if (g_game_mode_instance.game_mode_data != NULL) {
-                    Heap_API_Free(g_game_mode_instance.game_mode_data);
+                g_pause_next_state = eReactionTestState_Init;
+
+                if (osTimerStart(g_pause_timer, WAIT_BETWEEN_ATTEMPTS) != osOK) {
+                    TRACE_ERR("Failed to start pause timer\n");
+
+                    g_reaction_test_state = g_pause_next_state;
+
+                    break;
                 }
 
-                osDelay(WAIT_BETWEEN_ATTEMPTS);
+                g_reaction_test_state = eReactionTestState_Pause;
 
-                g_reaction_test_state = eReactionTestState_Init;
+#ifdef USE_RESULTS_LOG
+                Results_Log_Resume();
+                Results_Log_Flush();
+#endif
             } break;
             default: {
-                break;
-            }
-        }
-    }
+                // Idle, WaitClear, Measure and Pause only advance on events
+                bool is_sampling = (g_reaction_test_state == eReactionTestState_WaitClear) || (g_reaction_test_state == eReactionTestState_Measure);
+                uint32_t timeout = is_sampling ? MEASURE_EVENT_WAIT : osWaitForever;
 
-    osThreadYield();
-}
-
-static bool Reaction_Test_InitModules (void) {
-    bool is_init_successful = true;
-
-    for (eModule_t module = eModule_First; module < eModule_Last; module++) {
-        g_dynamic_reaction_test_desc[module].registerd_distance = 0;
-        g_dynamic_reaction_test_desc[module].state = eModuleState_Off;
-        
-        if (osTimerIsRunning(g_dynamic_reaction_test_desc[module].segment_timer)) {
-            if (osTimerStop(g_dynamic_reaction_test_desc[module].segment_timer) != osOK) {
-                TRACE_ERR("Failed to stop timer on [%d] module\n", module);
-            }
-        }
+                uint32_t flags = osThreadFlagsWait(ALL_THREAD_FLAGS, osFlagsWaitAny, timeout);
 
-        if (!WS2812B_API_Reset(g_static_reaction_test_desc[module].ws2812b)) {
-            TRACE_ERR("Failed to init [%d] module: WS2812B API Reset failed\n", module);
+                if ((flags & osFlagsError) == 0) {
+                    Reaction_Test_HandleThreadFlags(flags);
 
-            is_init_successful = false;
+                    break;
+                }
 
-            break;
+#ifndef USE_VL53L0X_DATA_READY
+                if (is_sampling) {
+                    Reaction_Test_PollModules();
+                }
+#endif
+            } break;
         }
-        
-       if (!VL53L0X_API_StopMeasuring(g_static_reaction_test_desc[module].vl53l0x)) {
-           TRACE_ERR("Failed to init [%d] module: VL53L0X API Disable failed\n", module);
-
-           is_init_successful = false;
-
-           return false;
-       }
     }
 
-    return is_init_successful;
+    osThreadYield();
 }
 
-static void Reaction_Test_DelayStartTimer (void *arg) {
-    if (arg == NULL) {
-        TRACE_ERR("Failed timer: Invalid argument\n");
+/// Called on the UI thread, which receives the IO driver button event
+static void Reaction_Test_StartStopPressed (void) {
+    sReactionTestEvent_t event = {.event = eReactionTestEvent_StartStop, .module = eModule_First, .timestamp = Timestamp_GetUs()};
 
-        return;
+    // The UI thread must not block on a busy game thread, a lost press is only logged
+    if (!Reaction_Test_PostEvent(&event, 0U)) {
+        TRACE_WRN("START/STOP dropped: Event queue full\n");
     }
 
-    sReactionTestDynamicDesc_t *module = (sReactionTestDynamicDesc_t *)arg;
+    return;
+}
 
-    if (!Reaction_Test_IsCorrectModule(module->module)) {
-        TRACE_ERR("Failed timer: Incorrect [%d] Module\n", module->module);
+static void Reaction_Test_StartSession (void) {
+#ifdef USE_RESULTS_LOG
+    // A record or erase already in progress finishes here in Idle, nothing new starts until the next Idle
+    Results_Log_Suspend();
+#endif
 
-        return;
-    }
+    Reaction_Test_StopErrorFeedback();
 
-    if (g_reaction_test_state != eReactionTestState_Measure) {
-        TRACE_ERR("Failed timer: Incorrect FSM state[%d]\n", g_reaction_test_state);
+    if (!Reaction_Test_SetupGameMode()) {
+        g_reaction_test_state = eReactionTestState_Init;
 
         return;
     }
 
-    if (module->state != eModuleState_Ready) {
-        TRACE_ERR("Failed timer: Module [%d] state [%d] incorrect\n", module->module, module->state);
+    TRACE_INFO("Start reaction test\n");
 
-        g_reaction_test_state = eReactionTestState_Init;
-
-        return;
-    }
+    g_reaction_test_state = eReactionTestState_Start;
 
-    g_led_animation.device = g_static_reaction_test_desc[module->module].ws2812b;
-    g_led_animation.animation = eLedAnimation_SegmentFill;
-    g_led_animation.data = &g_dynamic_reaction_test_desc[module->module].led_segment_fill; 
+    return;
+}
 
-    if (!WS2812B_API_AddAnimation(&g_led_animation)) {
-        //TRACE_ERR("Failed to add animation to [%d] module\n", module->module);
+static void Reaction_Test_HandleEvent (const sReactionTestEvent_t *event) {
+    if (event->event == eReactionTestEvent_StartStop) {
+        switch (g_reaction_test_state) {
+            case eReactionTestState_Idle: {
+                Reaction_Test_StartSession();
+            } break;
+            case eReactionTestState_Pause: {
+                // The session is already over, the press asks for the next one instead of stopping
+                g_is_start_pending = true;
+                g_reaction_test_state = eReactionTestState_Init;
+            } break;
+            default: {
+                TRACE_INFO("Stop reaction test\n");
 
-        g_reaction_test_state = eReactionTestState_Init;
+                g_reaction_test_state = eReactionTestState_Init;
+            } break;
+        }
 
         return;
     }
 
-    osEventFlagsSet(g_timer_flag, module->timer_event_flag);
+    switch (g_reaction_test_state) {
+        case eReactionTestState_WaitClear: {
+            switch (event->event) {
+                case eReactionTestEvent_DataReady: {
+                    Reaction_Test_HandleSample(event->module, event->timestamp);
+                } break;
+                case eReactionTestEvent_ClearTimeout: {
+                    Reaction_Test_HandleGameError(eGameError_ClearStripTimeout);
+                } break;
+                default: {
+                    break;
+                }
+            }
 
-    if (osTimerStart(g_measure_timeout_timer, DEFAULT_MEASURE_TIMEOUT) != osOK) {
-        TRACE_ERR("Failed to start measure timeout timer\n");
+            Reaction_Test_CheckClear();
+        } break;
+        case eReactionTestState_Measure: {
+            switch (event->event) {
+                case eReactionTestEvent_DataReady: {
+                    Reaction_Test_HandleSample(event->module, event->timestamp);
+                } break;
+                case eReactionTestEvent_MeasureTimeout: {
+                    TRACE_ERR("Measure timeout\n");
 
-        g_reaction_test_state = eReactionTestState_Init;
+                    Reaction_Test_HandleGameError(eGameError_MeasureTimeout);
+                } break;
+                default: {
+                    break;
+                }
+            }
+
+            Reaction_Test_CheckRegistered();
+        } break;
+        case eReactionTestState_Pause: {
+            if (event->event == eReactionTestEvent_PauseElapsed) {
+                g_reaction_test_state = g_pause_next_state;
+            }
+        } break;
+        default: {
+            break;
+        }
     }
 
     return;
 }
 
-static void Reaction_Test_MeasureTimeoutTimer (void *arg) {
-    if (g_reaction_test_state == eReactionTestState_Measure) {
-        g_reaction_test_state = eReactionTestState_Init;
-
-        //Reaction_Test_HandleGameError(eGameError_MeasureTimeout);
+static void Reaction_Test_HandleThreadFlags (const uint32_t flags) {
+    sReactionTestEvent_t event = {0};
 
-        osEventFlagsSet(g_timer_flag, DEFAULT_MEASURE_TIMEOUT_FLAG);
+    if ((flags & EVENT_QUEUE_THREAD_FLAG) != 0) {
+        while (osMessageQueueGet(g_event_queue, &event, NULL, 0U) == osOK) {
+            Reaction_Test_HandleEvent(&event);
+        }
     }
 
-    return;
-}
+#ifdef USE_VL53L0X_DATA_READY
+    if ((flags & DATA_READY_THREAD_FLAG) != 0) {
+        event.event = eReactionTestEvent_DataReady;
 
-static sModuleState_t Reaction_Test_IsModuleClear (const eModule_t module) {
-    if (!Reaction_Test_IsCorrectModule(module)) {
-        TRACE_ERR("Failed to check module [%d] state: Incorrect Module\n", module);
+        uint8_t order[eModule_Last];
+        uint8_t count = Reaction_Test_OrderModules(__atomic_exchange_n(&g_data_ready_modules, 0, __ATOMIC_ACQUIRE), order);
 
-        return eModuleState_Last;
+        for (uint8_t index = 0; index < count; index++) {
+            event.module = (eModule_t) order[index];
+            event.timestamp = g_data_ready_time[event.module];
+
+            Reaction_Test_HandleEvent(&event);
+        }
     }
+#endif
 
-    if ((g_dynamic_reaction_test_desc[module].state == eModuleState_Off) || (g_dynamic_reaction_test_desc[module].state == eModuleState_Default)) {
-        TRACE_ERR("Failed to check module [%d] state: Module state [%d]\n", module, g_dynamic_reaction_test_desc[module].state);
+    if (((flags & CUE_THREAD_FLAGS) != 0) && (g_reaction_test_state == eReactionTestState_Measure)) {
+        if (!Reaction_Test_StartCues(flags & CUE_THREAD_FLAGS)) {
+            g_reaction_test_state = eReactionTestState_Init;
+        }
 
-        return eModuleState_Last;
+        Reaction_Test_CheckRegistered();
+    }
+
+    if ((flags & ERROR_BLINK_THREAD_FLAG) != 0) {
+        Reaction_Test_ToggleErrorFeedback();
     }
 
-    return eModuleState_Ready;
+    if ((flags & MEASURE_TIMEOUT_THREAD_FLAG) != 0) {
+        event.event = eReactionTestEvent_MeasureTimeout;
+        event.module = eModule_First;
+        event.timestamp = Timestamp_GetUs();
 
-    if (!VL53L0X_API_GetDistance(g_static_reaction_test_desc[module].vl53l0x, &g_dynamic_reaction_test_desc[module].registerd_distance, DEFAULT_GET_DISTANCE_TIMEOUT)) {
-        return eModuleState_FailedGetDistance;
+        Reaction_Test_HandleEvent(&event);
     }
 
-    // if ((g_dynamic_reaction_test_desc[module].registerd_distance > g_dynamic_reaction_test_desc[module].led_strip_length) || g_dynamic_reaction_test_desc[module].registerd_distance == 0) {
-    //     return eModuleState_Ready;
-    // } else {
-    //     return eModuleState_Last;
-    // }
+    return;
 }
 
-/**********************************************************************************************************************
- * Definitions of exported functions
- *********************************************************************************************************************/
-
+static bool Reaction_Test_PostEvent (const sReactionTestEvent_t *event, const uint32_t timeout) {
+    if (osMessageQueuePut(g_event_queue, event, 0U, timeout) != osOK) {
+        return false;
+    }
+
+    osThreadFlagsSet(g_reaction_test_thread_id, EVENT_QUEUE_THREAD_FLAG);
+
+    return true;
+}
+
+static bool Reaction_Test_SetupGameMode (void) {
+    srand(osKernelGetTickCount());
+
+    switch (g_game_mode) {
+        case eGameMode_Classic: {
+            sGameModeClassic_t *data = Session_Arena_Alloc(g_game_mode_instance.session_arena, sizeof(sGameModeClassic_t));
+            
+            if (data == NULL) {
+                TRACE_ERR("Failed alloc memory for game mode data\n");
+
+                return false;
+            }
+
+            data->difficulty = g_difficulty;
+            data->total_attempts = g_total_attempts;
+            data->session_arena = g_game_mode_instance.session_arena;
+
+            g_game_mode_instance.game_mode_data = data;
+            g_game_mode_instance.game_mode_start = Game_Mode_Classic_Start;
+            g_game_mode_instance.game_mode_process = Game_Mode_Classic_Process;
+            g_game_mode_instance.game_mode_is_restart = Game_Mode_Classic_IsRestart;
+            g_game_mode_instance.game_mode_stop = Game_Mode_Classic_Stop;
+            g_game_mode_instance.game_mode_reset = Game_Mode_Classic_Reset;
+            g_game_mode_instance.get_active_modules = Game_Mode_Classic_GetActiveModules;
+        } break;
+        default: {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool Reaction_Test_StartWaitClear (void) {
+    uint32_t timeout = WAIT_CLEAR_TIME;
+    uint32_t now = Timestamp_GetUs();
+
+    // During an overlapped pause the strips only have to be clear once the pause is over
+    if (g_is_pause_overlapped && ((int32_t) (g_pause_end_time - now) > 0)) {
+        timeout += (g_pause_end_time - now) / 1000;
+    }
+
+    if (osTimerStart(g_clear_timeout_timer, timeout) != osOK) {
+        TRACE_ERR("Failed to start clear timeout timer\n");
+
+        return false;
+    }
+
+    return true;
+}
+
+static bool Reaction_Test_ArmCues (void) {
+    uint32_t base_time = Timestamp_GetUs();
+
+    g_is_pause_overlapped = false;
+
+    for (uint32_t pending = g_active_modules; pending != 0; pending &= pending - 1) {
+        eModule_t module = MODULE_MASK_LOWEST(pending);
+        sReactionTestDynamicDesc_t *desc = &g_dynamic_reaction_test_desc[module];
+
+        desc->cue_scheduled_time = base_time + (desc->cue_delay * 1000);
+
+        // The base frame went out clear samples ago, the cue frame is encoded now so the scheduled instant only starts the transfer
+        Led_Compositor_SetTarget(module, g_static_reaction_test_desc[module].target_color, desc->target_start_led, desc->target_end_led);
+
+        if (!Led_Compositor_Render(module)) {
+            TRACE_ERR("Failed to render cue on [%d] module\n", module);
+
+            return false;
+        }
+
+        if (!Cue_Scheduler_Arm(module, desc->cue_scheduled_time)) {
+            TRACE_ERR("Failed to arm cue on [%d] module\n", module);
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool Reaction_Test_StartCues (const uint32_t cue_flags) {
+    uint32_t cue_time[eModule_Last] = {0};
+
+    uint32_t not_ready = cue_flags & ~g_module_state_mask[eModuleState_Ready];
+
+    if (not_ready != 0) {
+        eModule_t module = MODULE_MASK_LOWEST(not_ready);
+
+        TRACE_ERR("Failed cue: Module [%d] state [%d] incorrect\n", module, g_dynamic_reaction_test_desc[module].state);
+
+        return false;
+    }
+
+    // Frames were rendered when the cues were armed, start every due strip back to back before any bookkeeping
+    for (uint32_t pending = cue_flags; pending != 0; pending &= pending - 1) {
+        eModule_t module = MODULE_MASK_LOWEST(pending);
+
+        cue_time[module] = Timestamp_GetUs();
+
+        if (!Led_Compositor_Show(module)) {
+            //TRACE_ERR("Failed to start animation on [%d] module\n", module);
+
+            return false;
+        }
+    }
+
+    for (uint32_t pending = cue_flags; pending != 0; pending &= pending - 1) {
+        eModule_t module = MODULE_MASK_LOWEST(pending);
+        sReactionTestDynamicDesc_t *desc = &g_dynamic_reaction_test_desc[module];
+
+#ifdef ENABLE_BENCHMARK
+        uint32_t jitter_bucket = Timestamp_ElapsedUs(desc->cue_scheduled_time, cue_time[module]) / CUE_JITTER_BUCKET_US;
+
+        if (jitter_bucket >= CUE_JITTER_BUCKETS) {
+            jitter_bucket = CUE_JITTER_BUCKETS - 1;
+        }
+
+        g_cue_jitter_histogram[jitter_bucket]++;
+#endif
+
+        Reaction_Test_SetModuleState(module, eModuleState_Measuring);
+
+        // Reaction time counts from the moment the cue is on the strip
+        desc->cue_latency_us = Led_Compositor_GetShowLatencyUs(module);
+        desc->start_time = cue_time[module] + desc->cue_latency_us;
+
+        TRACE_LOG(eTraceLogId_CueLatency, module, desc->cue_latency_us);
+
+#ifdef USE_SIMULATED_SENSORS
+        Sensor_Sim_Cue(module, desc->start_time);
+#endif
+    }
+
+    if (osTimerStart(g_measure_timeout_timer, DEFAULT_MEASURE_TIMEOUT) != osOK) {
+        TRACE_ERR("Failed to start measure timeout timer\n");
+
+        return false;
+    }
+
+    return true;
+}
+
+#ifndef USE_VL53L0X_DATA_READY
+static void Reaction_Test_PollModules (void) {
+    eReactionTestState_t state = g_reaction_test_state;
+    uint32_t sampling = g_module_state_mask[eModuleState_Active] | g_module_state_mask[eModuleState_Ready] | g_module_state_mask[eModuleState_Measuring];
+    uint8_t order[eModule_Last];
+
+    // Only modules still waiting for a sample are visited, registered ones cost nothing per tick
+    uint8_t count = Reaction_Test_OrderModules(g_active_modules & sampling, order);
+
+    for (uint8_t index = 0; index < count; index++) {
+        Reaction_Test_HandleSample((eModule_t) order[index], Timestamp_GetUs());
+
+        // A game error already moved the FSM on, the remaining modules are reset by Init
+        if (g_reaction_test_state != state) {
+            return;
+        }
+    }
+
+    Reaction_Test_CheckClear();
+    Reaction_Test_CheckRegistered();
+
+    return;
+}
+#endif
+
+static void Reaction_Test_CheckClear (void) {
+    if (g_reaction_test_state != eReactionTestState_WaitClear) {
+        return;
+    }
+
+    if ((g_module_state_mask[eModuleState_Ready] & g_active_modules) != g_active_modules) {
+        return;
+    }
+
+    // Strips cleared during an overlapped pause wait for its end, the pause elapsed event checks again
+    if (g_is_pause_overlapped && osTimerIsRunning(g_pause_timer)) {
+        return;
+    }
+
+    // Every strip is clear, all cues count from this one moment
+    osTimerStop(g_clear_timeout_timer);
+
+    // No LCD traffic competes with sensor reads while a hand is being timed
+    Lcd_Shadow_Hold();
+
+    if (!Reaction_Test_ArmCues()) {
+        g_reaction_test_state = eReactionTestState_Init;
+
+        return;
+    }
+
+    g_reaction_test_state = eReactionTestState_Measure;
+
+    return;
+}
+
+static void Reaction_Test_CheckRegistered (void) {
+    if (g_reaction_test_state != eReactionTestState_Measure) {
+        return;
+    }
+
+    if ((g_module_state_mask[eModuleState_Registered] & g_active_modules) == g_active_modules) {
+        g_reaction_test_state = eReactionTestState_Process;
+    }
+
+    return;
+}
+
+static void Reaction_Test_SetModuleState (const eModule_t module, const sModuleState_t state) {
+    sReactionTestDynamicDesc_t *desc = &g_dynamic_reaction_test_desc[module];
+
+    g_module_state_mask[desc->state] &= ~MODULE_MASK(module);
+    g_module_state_mask[state] |= MODULE_MASK(module);
+
+    desc->state = state;
+
+    return;
+}
+
+static bool Reaction_Test_InitModules (void) {
+    bool is_init_successful = true;
+
+    g_active_modules = 0;
+
+    for (eModule_t module = eModule_First; module < eModule_Last; module++) {
+        g_dynamic_reaction_test_desc[module].registerd_distance = 0;
+        Reaction_Test_SetModuleState(module, eModuleState_Off);
+
+#ifdef USE_VL53L0X_DATA_READY
+        Sensor_Exti_Disable(module);
+#endif
+        
+        Cue_Scheduler_Cancel(module);
+
+        if (!Led_Compositor_Reset(module)) {
+            TRACE_ERR("Failed to init [%d] module: WS2812B API Reset failed\n", module);
+
+            is_init_successful = false;
+
+            break;
+        }
+        
+       if (!Reaction_Test_StopRanging(module)) {
+           TRACE_ERR("Failed to init [%d] module: VL53L0X API Disable failed\n", module);
+
+           is_init_successful = false;
+
+           return false;
+       }
+    }
+
+    return is_init_successful;
+}
+
+static void Reaction_Test_CueDue (const eModule_t module, const uint32_t cue_time) {
+    osThreadFlagsSet(g_reaction_test_thread_id, CUE_THREAD_FLAG(module));
+
+    return;
+}
+
+static void Reaction_Test_MeasureTimeoutTimer (void *arg) {
+    if ((osThreadFlagsSet(g_reaction_test_thread_id, MEASURE_TIMEOUT_THREAD_FLAG) & osFlagsError) != 0) {
+        TRACE_ERR("Failed timer: Measure timeout flag not set\n");
+    }
+
+    return;
+}
+
+static void Reaction_Test_ClearTimeoutTimer (void *arg) {
+    sReactionTestEvent_t event = {.event = eReactionTestEvent_ClearTimeout, .module = eModule_First, .timestamp = Timestamp_GetUs()};
+
+    if (!Reaction_Test_PostEvent(&event, 0U)) {
+        TRACE_ERR("Failed timer: Event queue full\n");
+    }
+
+    return;
+}
+
+static void Reaction_Test_PauseTimer (void *arg) {
+    sReactionTestEvent_t event = {.event = eReactionTestEvent_PauseElapsed, .module = eModule_First, .timestamp = Timestamp_GetUs()};
+
+    if (!Reaction_Test_PostEvent(&event, 0U)) {
+        TRACE_ERR("Failed timer: Event queue full\n");
+    }
+
+    return;
+}
+
+static void Reaction_Test_ErrorBlinkTimer (void *arg) {
+    osThreadFlagsSet(g_reaction_test_thread_id, ERROR_BLINK_THREAD_FLAG);
+
+    return;
+}
+
+static void Reaction_Test_StartErrorFeedback (const eGameError_t error) {
+    for (eModule_t module = eModule_First; module < eModule_Last; module++) {
+        Led_Compositor_SetOverlay(module, ERROR_LED_COLOR);
+        Led_Compositor_Update(module);
+    }
+
+    g_error_blink_toggles = ERROR_BLINK_TOGGLES;
+
+    if (osTimerStart(g_error_blink_timer, ERROR_BLINK_PERIOD) != osOK) {
+        TRACE_ERR("Failed to start error blink timer\n");
+    }
+
+    g_message.data = (char *) g_static_game_error_text[error];
+    g_message.size = strlen(g_message.data);
+
+    Reaction_Test_App_DisplayLcd(g_message, eLcdRow_1, eLcdColumn_1, eLcdOption_None);
+
+    return;
+}
+
+static void Reaction_Test_ToggleErrorFeedback (void) {
+    if (g_error_blink_toggles == 0) {
+        return;
+    }
+
+    g_error_blink_toggles--;
+
+    for (eModule_t module = eModule_First; module < eModule_Last; module++) {
+        // Even toggles clear the overlay, so the last one always leaves the strips clear
+        if ((g_error_blink_toggles % 2) == 0) {
+            Led_Compositor_ClearLayer(module, eLedLayer_Overlay);
+        } else {
+            Led_Compositor_SetOverlay(module, ERROR_LED_COLOR);
+        }
+
+        Led_Compositor_Update(module);
+    }
+
+    if (g_error_blink_toggles == 0) {
+        osTimerStop(g_error_blink_timer);
+    }
+
+    return;
+}
+
+static void Reaction_Test_StopErrorFeedback (void) {
+    if (g_error_blink_toggles == 0) {
+        return;
+    }
+
+    g_error_blink_toggles = 0;
+
+    osTimerStop(g_error_blink_timer);
+
+    for (eModule_t module = eModule_First; module < eModule_Last; module++) {
+        Led_Compositor_ClearLayer(module, eLedLayer_Overlay);
+        Led_Compositor_Update(module);
+    }
+
+    return;
+}
+
+static sModuleState_t Reaction_Test_IsModuleClear (const eModule_t module) {
+    if (!Reaction_Test_IsCorrectModule(module)) {
+        TRACE_ERR("Failed to check module [%d] state: Incorrect Module\n", module);
+
+        return eModuleState_Last;
+    }
+
+    if ((g_dynamic_reaction_test_desc[module].state == eModuleState_Off) || (g_dynamic_reaction_test_desc[module].state == eModuleState_Default)) {
+        TRACE_ERR("Failed to check module [%d] state: Module state [%d]\n", module, g_dynamic_reaction_test_desc[module].state);
+
+        return eModuleState_Last;
+    }
+
+    // Judged on the last sample, no reading is taken here
+    if (g_dynamic_reaction_test_desc[module].registerd_distance > g_dynamic_reaction_test_desc[module].led_strip_length) {
+        return eModuleState_Ready;
+    }
+
+    return eModuleState_Last;
+}
+
+static void Reaction_Test_HandleSample (const eModule_t module, const uint32_t timestamp) {
+    if (!Reaction_Test_IsCorrectModule(module)) {
+        return;
+    }
+
+    sReactionTestDynamicDesc_t *desc = &g_dynamic_reaction_test_desc[module];
+
+    // A queued sample of a module that already stopped ranging would only wait out a conversion that never comes
+    if ((desc->state != eModuleState_Active) && (desc->state != eModuleState_Ready) && (desc->state != eModuleState_Measuring)) {
+        return;
+    }
+
+#ifdef USE_VL53L0X_DATA_READY
+    // Reading the result also clears the sensor interrupt and releases GPIO1 for the next sample
+    if (!Reaction_Test_GetDistance(module, DEFAULT_GET_DISTANCE_TIMEOUT)) {
+        return;
+    }
+#else
+    if (!Reaction_Test_GetDistance(module, POLL_GET_DISTANCE_TIMEOUT)) {
+        return;
+    }
+#endif
+
+#ifdef ENABLE_BENCHMARK
+    Reaction_Test_BenchmarkSample(module, timestamp);
+#endif
+
+    // An invalid reading says nothing about the hand, it must not confirm, break or register a clear strip
+    if (desc->registerd_distance == INVALID_DISTANCE_MM) {
+        return;
+    }
+
+    switch (desc->state) {
+        case eModuleState_Active: {
+            if (Reaction_Test_IsModuleClear(module) != eModuleState_Ready) {
+                TRACE_LOG(eTraceLogId_Distance, module, desc->registerd_distance);
+
+                desc->clear_samples = 0;
+
+                break;
+            }
+
+            desc->clear_samples++;
+
+            if (desc->clear_samples >= CLEAR_CONFIRM_SAMPLES) {
+                Reaction_Test_SetModuleState(module, eModuleState_Ready);
+            }
+        } break;
+        case eModuleState_Ready: {
+            if (Reaction_Test_IsModuleClear(module) == eModuleState_Ready) {
+                break;
+            }
+
+            if (g_reaction_test_state == eReactionTestState_Measure) {
+                Reaction_Test_HandleGameError(eGameError_InvalidStart);
+
+                break;
+            }
+
+            // Hand came back before every strip was clear, this one has to clear again
+            desc->clear_samples = 0;
+            Reaction_Test_SetModuleState(module, eModuleState_Active);
+        } break;
+        case eModuleState_Measuring: {
+            if (desc->registerd_distance > desc->led_strip_length) {
+                break;
+            }
+
+            desc->end_time = timestamp;
+            Reaction_Test_SetModuleState(module, eModuleState_Registered);
+
+            // Nothing left to wait for on this module, keep its sensor off the bus for the rest of the attempt
+#ifdef USE_VL53L0X_DATA_READY
+            Sensor_Exti_Disable(module);
+#endif
+
+            if (!Reaction_Test_StopRanging(module)) {
+                TRACE_ERR("Failed to stop [%d] module sensor\n", module);
+            }
+
+            // The strip is cleared after scoring, a reset here could wait out a transfer while other modules sample
+        } break;
+        default: {
+            break;
+        }
+    }
+
+    return;
+}
+
+/// Bus order for the modules of a mask, batched per mux channel with USE_I2C_MUX
+static uint8_t Reaction_Test_OrderModules (const uint32_t modules, uint8_t *order) {
+#ifdef USE_I2C_MUX
+    return Sensor_Mux_Schedule(&g_sensor_mux, modules, order);
+#else
+    uint8_t count = 0;
+
+    for (uint32_t pending = modules; pending != 0; pending &= pending - 1) {
+        order[count] = MODULE_MASK_LOWEST(pending);
+        count++;
+    }
+
+    return count;
+#endif
+}
+
+/// Points the mux at the module's sensor, the mux is only written when the channel changes
+static bool Reaction_Test_SelectSensor (const eModule_t module) {
+#ifdef USE_I2C_MUX
+    return Sensor_Mux_Select(&g_sensor_mux, module);
+#else
+    return true;
+#endif
+}
+
+#ifdef USE_I2C_MUX
+/// Runs with the bus lock held, the control byte enables the one channel
+static bool Reaction_Test_SelectMuxChannel (const uint8_t channel) {
+#ifdef USE_SIMULATED_SENSORS
+    return Sensor_Sim_SelectChannel(channel);
+#else
+    return I2c_Bus_WriteByte(I2C_MUX_ADDRESS, (uint8_t) (1U << channel));
+#endif
+}
+#endif
+
+static bool Reaction_Test_GetDistance (const eModule_t module, const uint32_t timeout) {
+#ifdef USE_SIMULATED_SENSORS
+    if (!Reaction_Test_SelectSensor(module)) {
+        return false;
+    }
+
+    return Sensor_Sim_GetDistance(module, &g_dynamic_reaction_test_desc[module].registerd_distance);
+#else
+    I2c_Bus_Lock();
+
+    bool is_read = Reaction_Test_SelectSensor(module) && VL53L0X_API_GetDistance(g_static_reaction_test_desc[module].vl53l0x, &g_dynamic_reaction_test_desc[module].registerd_distance, timeout);
+
+    I2c_Bus_Unlock();
+
+    return is_read;
+#endif
+}
+
+static bool Reaction_Test_StartRanging (const eModule_t module) {
+#ifdef USE_SIMULATED_SENSORS
+    if (!Reaction_Test_SelectSensor(module)) {
+        return false;
+    }
+
+    return Sensor_Sim_StartMeasuring(module);
+#else
+    I2c_Bus_Lock();
+
+    bool is_started = Reaction_Test_SelectSensor(module) && VL53L0X_API_StartMeasuring(g_static_reaction_test_desc[module].vl53l0x);
+
+    I2c_Bus_Unlock();
+
+    return is_started;
+#endif
+}
+
+static bool Reaction_Test_StopRanging (const eModule_t module) {
+#ifdef USE_SIMULATED_SENSORS
+    if (!Reaction_Test_SelectSensor(module)) {
+        return false;
+    }
+
+    return Sensor_Sim_StopMeasuring(module);
+#else
+    I2c_Bus_Lock();
+
+    bool is_stopped = Reaction_Test_SelectSensor(module) && VL53L0X_API_StopMeasuring(g_static_reaction_test_desc[module].vl53l0x);
+
+    I2c_Bus_Unlock();
+
+    return is_stopped;
+#endif
+}
+
+#ifdef ENABLE_BENCHMARK
+static void Reaction_Test_BenchmarkSample (const eModule_t module, const uint32_t timestamp) {
+    if (g_sample_rate_benchmark[module].samples == 0) {
+        g_sample_rate_benchmark[module].first_sample_time = timestamp;
+    }
+
+    g_sample_rate_benchmark[module].last_sample_time = timestamp;
+    g_sample_rate_benchmark[module].samples++;
+
+    return;
+}
+
+static void Reaction_Test_BenchmarkReport (void) {
+    uint32_t total_rate = 0;
+
+    for (uint32_t pending = g_active_modules; pending != 0; pending &= pending - 1) {
+        eModule_t module = MODULE_MASK_LOWEST(pending);
+        sSampleRateBenchmark_t *benchmark = &g_sample_rate_benchmark[module];
+        uint32_t elapsed = Timestamp_ElapsedUs(benchmark->first_sample_time, benchmark->last_sample_time);
+
+        if ((benchmark->samples < 2) || (elapsed == 0)) {
+            TRACE_INFO("Module [%d]: not enough samples\n", module);
+
+            continue;
+        }
+
+        uint32_t rate = ((benchmark->samples - 1) * 1000000UL) / elapsed;
+
+        total_rate += rate;
+
+        TRACE_INFO("Module [%d]: %lu samples, %lu samples/s\n", module, benchmark->samples, rate);
+    }
+
+    // What the shared I2C bus delivered across all sampling modules
+    TRACE_INFO("Aggregate: %lu samples/s\n", total_rate);
+
+#ifdef USE_I2C_MUX
+    TRACE_INFO("Mux: %lu sensor transactions, %lu channel switches\n", g_sensor_mux.transactions, g_sensor_mux.switches);
+#endif
+
+    for (uint8_t bucket = 0; bucket < (CUE_JITTER_BUCKETS - 1); bucket++) {
+        TRACE_INFO("Cue jitter %3d-%3d us: %lu\n", bucket * CUE_JITTER_BUCKET_US, ((bucket + 1) * CUE_JITTER_BUCKET_US) - 1, g_cue_jitter_histogram[bucket]);
+    }
+
+    TRACE_INFO("Cue jitter >= %d us: %lu\n", (CUE_JITTER_BUCKETS - 1) * CUE_JITTER_BUCKET_US, g_cue_jitter_histogram[CUE_JITTER_BUCKETS - 1]);
+
+    Led_Compositor_BenchmarkReport();
+    Lcd_Shadow_BenchmarkReport();
+    Ui_Task_BenchmarkReport();
+
+    // Stack sizes are tuned from these low-water marks, heap_4 keeps the lowest free size since boot
+    TRACE_INFO("Reaction thread: %lu B stack unused\n", osThreadGetStackSpace(g_reaction_test_thread_id));
+    TRACE_INFO("Heap: %u B free, %u B lowest\n", xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize());
+
+    return;
+}
+#endif
+
+#ifdef USE_VL53L0X_DATA_READY
+/// Called from EXTI context
+static void Reaction_Test_SensorDataReady (const eModule_t module, const uint32_t timestamp) {
+    g_data_ready_time[module] = timestamp;
+
+    __atomic_fetch_or(&g_data_ready_modules, MODULE_MASK(module), __ATOMIC_RELEASE);
+
+    osThreadFlagsSet(g_reaction_test_thread_id, DATA_READY_THREAD_FLAG);
+
+    return;
+}
+#endif
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
 bool Reaction_Test_App_Init (void) {
     if (g_is_initialized) {
         return true;
     }
 
-    if (g_start_button_event == NULL) {
-        g_start_button_event = osEventFlagsNew(&g_start_button_event_attributes);
+    if (!I2c_Bus_Init()) {
+        return false;
     }
 
-    if (!IO_API_Init(START_STOP_BUTTON, g_start_button_event)) {
+#ifdef USE_I2C_MUX
+    if (!Sensor_Mux_Init(&g_sensor_mux, g_static_mux_channel_lut, eModule_Last, Reaction_Test_SelectMuxChannel)) {
+        TRACE_ERR("Failed to init sensor mux: Invalid channel\n");
+
         return false;
     }
+#endif
 
     if (!WS2812B_API_Init()) {
         return false;
     }
 
-    if (eModule_Last == 0) {
-        TRACE_ERR("Failed to init reaction test: No modules available\n");
+    if (g_event_queue == NULL) {
+        g_event_queue = osMessageQueueNew(EVENT_QUEUE_SIZE, sizeof(sReactionTestEvent_t), &g_event_queue_attributes);
+    }
+
+    if (g_event_queue == NULL) {
+        TRACE_ERR("Failed to create event queue\n");
 
         return false;
     }
 
+#ifdef USE_VL53L0X_DATA_READY
+    if (!Sensor_Exti_Init(Reaction_Test_SensorDataReady)) {
+        return false;
+    }
+#endif
+
+    if (!Cue_Scheduler_Init(Reaction_Test_CueDue)) {
+        return false;
+    }
+
+    if (!Ui_Task_Init()) {
+        return false;
+    }
+
+    if (!Ui_Task_AttachButton(START_STOP_BUTTON, STARTSTOP_TRIGGERED_EVENT, Reaction_Test_StartStopPressed)) {
+        return false;
+    }
+
     for (eModule_t module = eModule_First; module < eModule_Last; module++) {
-        g_dynamic_reaction_test_desc[module].led_solid_color.rgb = LED_GetColorRgb(g_static_reaction_test_desc[module].base_color);
+        Reaction_Test_SetModuleState(module, eModuleState_Off);
 
-        g_dynamic_reaction_test_desc[module].led_segment_fill.rgb_base = LED_GetColorRgb(g_static_reaction_test_desc[module].base_color);
-        g_dynamic_reaction_test_desc[module].led_segment_fill.rgb_segment = LED_GetColorRgb(g_static_reaction_test_desc[module].target_color);
+        g_dynamic_reaction_test_desc[module].target_led_count = DEFAULT_TARGET_LED_COUNT;
+
+        if (!Led_Compositor_Init(module, g_static_reaction_test_desc[module].ws2812b, g_static_reaction_test_desc[module].led_brightness)) {
+            return false;
+        }
 
         g_dynamic_reaction_test_desc[module].total_led_count = WS2812B_API_GetLedCount(g_static_reaction_test_desc[module].ws2812b);
         g_dynamic_reaction_test_desc[module].led_strip_length = (g_dynamic_reaction_test_desc[module].total_led_count * SINGLE_SEGMENT_LENGTH_UM) / 1000;
 
-        if (g_dynamic_reaction_test_desc[module].segment_timer == NULL) {
-            g_dynamic_reaction_test_desc[module].segment_timer = osTimerNew(Reaction_Test_DelayStartTimer, osTimerOnce, &g_dynamic_reaction_test_desc[module], &g_static_reaction_test_desc[module].segment_timer_attributes);
-        }
-
         g_dynamic_reaction_test_desc[module].module = module;
     }
 
+    // Timers first, the thread uses them as soon as it runs
+    if (g_measure_timeout_timer == NULL) {
+        g_measure_timeout_timer = osTimerNew(Reaction_Test_MeasureTimeoutTimer, osTimerOnce, NULL, &g_measure_timeout_timer_attributes);
+    }
+
+    if (g_clear_timeout_timer == NULL) {
+        g_clear_timeout_timer = osTimerNew(Reaction_Test_ClearTimeoutTimer, osTimerOnce, NULL, &g_clear_timeout_timer_attributes);
+    }
+
+    if (g_pause_timer == NULL) {
+        g_pause_timer = osTimerNew(Reaction_Test_PauseTimer, osTimerOnce, NULL, &g_pause_timer_attributes);
+    }
+
+    if (g_error_blink_timer == NULL) {
+        g_error_blink_timer = osTimerNew(Reaction_Test_ErrorBlinkTimer, osTimerPeriodic, NULL, &g_error_blink_timer_attributes);
+    }
+
+    if ((g_measure_timeout_timer == NULL) || (g_clear_timeout_timer == NULL) || (g_pause_timer == NULL) || (g_error_blink_timer == NULL)) {
+        TRACE_ERR("Failed to create reaction test timers\n");
+
+        return false;
+    }
+
     if (g_reaction_test_thread_id == NULL) {
         g_reaction_test_thread_id = osThreadNew(Reaction_Test_Thread, NULL, &g_reaction_test_thread_attributes);
     }
 
-    if (g_timer_flag == NULL) {
-        g_timer_flag = osEventFlagsNew(&g_start_button_event_attributes);
-    }
+    if (g_reaction_test_thread_id == NULL) {
+        TRACE_ERR("Failed to create reaction test thread\n");
 
-    if (g_measure_timeout_timer == NULL) {
-        g_measure_timeout_timer = osTimerNew(Reaction_Test_MeasureTimeoutTimer, osTimerOnce, NULL, &g_measure_timeout_timer_attributes);
+        return false;
     }
     
     g_is_initialized = true;
@@ -643,8 +1532,14 @@ bool Reaction_Test_App_UpdateModuleState (const eModule_t module, const sModuleS
         return false;
     }
 
+    if ((state < eModuleState_First) || (state >= eModuleState_Last)) {
+        TRACE_ERR("Failed to update module state: Incorrect state [%d]\n", state);
+
+        return false;
+    }
+
     if (g_dynamic_reaction_test_desc[module].state != state) {
-        g_dynamic_reaction_test_desc[module].state = state;
+        Reaction_Test_SetModuleState(module, state);
     }
 
     return true;
@@ -665,8 +1560,8 @@ bool Reaction_Test_App_SetRandomTargetPossition (const eModule_t module_data) {
         distance -= DEFAULT_HAND_OFFSET;
     }
 
-    g_dynamic_reaction_test_desc[module_data].led_segment_fill.segment_start_led = start_led;
-    g_dynamic_reaction_test_desc[module_data].led_segment_fill.segment_end_led = start_led + (g_dynamic_reaction_test_desc[module_data].target_led_count - 1);
+    g_dynamic_reaction_test_desc[module_data].target_start_led = start_led;
+    g_dynamic_reaction_test_desc[module_data].target_end_led = start_led + (g_dynamic_reaction_test_desc[module_data].target_led_count - 1);
     g_dynamic_reaction_test_desc[module_data].target_distance = distance;
 
     return true;
@@ -699,17 +1594,10 @@ bool Reaction_Test_App_ActiveteModule (const eModule_t module_data, const sModul
         return true;
     }
 
-    g_led_animation.device = g_static_reaction_test_desc[module_data].ws2812b;
-    g_led_animation.animation = eLedAnimation_SolidColor;
-    g_led_animation.data = &g_dynamic_reaction_test_desc[module_data].led_solid_color;
+    Led_Compositor_SetBase(module_data, g_static_reaction_test_desc[module_data].base_color);
+    Led_Compositor_ClearLayer(module_data, eLedLayer_Target);
 
-    if (!WS2812B_API_AddAnimation(&g_led_animation)) {
-        //TRACE_ERR("Failed to activate [%d] module: WS2812B API Add Animation failed\n", module_data);
-
-        return false;
-    }
-
-    if (!WS2812B_API_Start(g_static_reaction_test_desc[module_data].ws2812b)) {
+    if (!Led_Compositor_Update(module_data)) {
         //TRACE_ERR("Failed to activate [%d] module: WS2812B API Start failed\n", module_data);
 
         return false;
@@ -717,10 +1605,10 @@ bool Reaction_Test_App_ActiveteModule (const eModule_t module_data, const sModul
 
     switch (state) {
         case eModuleState_Default: {
-            g_dynamic_reaction_test_desc[module_data].state = eModuleState_Default;
+            Reaction_Test_SetModuleState(module_data, eModuleState_Default);
         } break;
         case eModuleState_Active: {
-            if (!VL53L0X_API_StartMeasuring(g_static_reaction_test_desc[module_data].vl53l0x)) {
+            if (!Reaction_Test_StartRanging(module_data)) {
                 //TRACE_ERR("Failed to enable vl53l0 on [%d] module\n", module);
         
                 g_reaction_test_state = eReactionTestState_Init;
@@ -728,7 +1616,12 @@ bool Reaction_Test_App_ActiveteModule (const eModule_t module_data, const sModul
                 return false;
             }
 
-            g_dynamic_reaction_test_desc[module_data].state = eModuleState_Active;
+            g_dynamic_reaction_test_desc[module_data].clear_samples = 0;
+            Reaction_Test_SetModuleState(module_data, eModuleState_Active);
+
+#ifdef USE_VL53L0X_DATA_READY
+            Sensor_Exti_Enable(module_data);
+#endif
         } break;
 
         default: {
@@ -752,30 +1645,21 @@ bool Reaction_Test_App_StartDelayTimer (const eModule_t module_data, const uint3
         return false;
     }
 
-    if (g_dynamic_reaction_test_desc[module_data].segment_timer == NULL) {
-        TRACE_ERR("Failed to activate [%d] module: Segment timer is NULL\n", module_data);
-
-        return false;
-    }
-
-    if (osTimerStart(g_dynamic_reaction_test_desc[module_data].segment_timer, delay) != osOK) {
-        TRACE_ERR("Failed to activate [%d] module: Failed to start segment timer\n", module_data);
-
-        return false;
-    }
+    // Rendered and armed together with the other active modules once every strip reads clear
+    g_dynamic_reaction_test_desc[module_data].cue_delay = delay;
 
     return true;
 }
 
+/// LCD calls only write the shadow and UART calls queue a line, the output runs later on the UI thread
+/// A line that finds the UI queue full is dropped and counted there, reporting it here would print on the caller's thread
 bool Reaction_Test_App_DisplayUart (const sMessage_t message) {
-    TRACE_INFO(message.data);
-
-    return true;
+    return Ui_Task_PrintUart(&message);
 }
 
-bool Reaction_Test_App_DisplayLcd (const sMessage_t message, const eLcdRow_t row, const eLcdColumn_t column, const eLcdOption_t option) {
-    if (!LCD_API_Print(LCD_DISPLAY, &message, row, column, option)) {
-        TRACE_ERR("Failed to print message on LCD\n");
+bool Reaction_Test_App_ClearLcd (void) {
+    if (!Ui_Task_ClearLcd()) {
+        TRACE_ERR("Failed to clear LCD\n");
 
         return false;
     }
@@ -783,45 +1667,21 @@ bool Reaction_Test_App_DisplayLcd (const sMessage_t message, const eLcdRow_t row
     return true;
 }
 
-bool Reaction_Test_WaitForClear (const eModule_t module) {
-    if (!Reaction_Test_IsCorrectModule(module)) {
-        TRACE_ERR("Failed to wait for clear: Incorrect Module\n");
-
-        return false;
-    }
+bool Reaction_Test_App_DisplayLcd (const sMessage_t message, const eLcdRow_t row, const eLcdColumn_t column, const eLcdOption_t option) {
+    // Display options act on the controller directly and cannot be replayed from the shadow
+    if (option != eLcdOption_None) {
+        TRACE_ERR("Failed to print message on LCD: Unsupported option\n");
 
-    if (g_dynamic_reaction_test_desc[module].state != eModuleState_Active) {
-        TRACE_ERR("Failed to wait for clear: Module [%d] state [%d] incorrect\n", module, g_dynamic_reaction_test_desc[module].state);
-        
         return false;
     }
 
-    uint32_t start_time = osKernelGetSysTimerCount();
-    uint32_t timeout = WAIT_CLEAR_TIME * SYSTEM_MS_TICS;
-    sModuleState_t state;
-
-    while ((osKernelGetSysTimerCount() - start_time) < timeout) {
-        state = Reaction_Test_IsModuleClear(module);
-        if (state == eModuleState_Ready) {
-            g_dynamic_reaction_test_desc[module].state = eModuleState_Ready;
-
-            return true;
-        }
-
-        TRACE_INFO("Distance: [%d]\n", g_dynamic_reaction_test_desc[module].registerd_distance);
+    if (!Ui_Task_PrintLcd(&message, row, column)) {
+        TRACE_ERR("Failed to print message on LCD\n");
 
-        osDelay(5);
+        return false;
     }
 
-    // if (state == eModuleState_FailedGetDistance) {
-    //     TRACE_WRN("Failed to get distance\n");
-
-    //     return true;
-    // }
-
-    TRACE_ERR("Failed to wait for clear: Timeout\n");
-    
-    return false;
+    return true;
 }
 
 void Reaction_Test_HandleGameError (eGameError_t error) {
@@ -835,49 +1695,28 @@ void Reaction_Test_HandleGameError (eGameError_t error) {
         osTimerStop(g_measure_timeout_timer);
     }
 
-    // TODO: Make leds blink
-
-    g_led_animation.animation = eLedAnimation_SolidColor;
-
-    sLedAnimationSolidColor_t led_error = {0};
-    led_error.rgb = LED_GetColorRgb(ERROR_LED_COLOR);
-    g_led_animation.data = &led_error;
+    if (osTimerIsRunning(g_clear_timeout_timer)) {
+        osTimerStop(g_clear_timeout_timer);
+    }
 
     for (eModule_t module = eModule_First; module < eModule_Last; module++) {
-        if (osTimerIsRunning(g_dynamic_reaction_test_desc[module].segment_timer)) {
-            if (osTimerStop(g_dynamic_reaction_test_desc[module].segment_timer) != osOK) {
-                TRACE_ERR("Failed to stop timer on [%d] module\n", module);
-            }
-        }
-
-        g_led_animation.device = g_static_reaction_test_desc[module].ws2812b;
-
-        if (!WS2812B_API_AddAnimation(&g_led_animation)) {
-            //TRACE_ERR("Failed to activate [%d] module: WS2812B API Add Animation failed\n", module_data);
-    
-            return;
-        }
-    
-        if (!WS2812B_API_Start(g_static_reaction_test_desc[module].ws2812b)) {
-            //TRACE_ERR("Failed to activate [%d] module: WS2812B API Start failed\n", module_data);
-    
-            return;
-        }
+        Cue_Scheduler_Cancel(module);
     }
 
     g_game_mode_instance.game_mode_reset(g_game_mode_instance.game_mode_data);
 
-    snprintf(g_message.data, UART_MESSAGE_SIZE, "Game Error [%d]\n", error);
-    Reaction_Test_App_DisplayUart(g_message);
+    char uart_message[UART_MESSAGE_SIZE];
+    sMessage_t message = {.data = uart_message, .size = 0};
 
-    LCD_API_Clear(eLcd_1);
+    snprintf(uart_message, UART_MESSAGE_SIZE, "Game Error [%d]: %s\n", error, g_static_game_error_text[error]);
+    message.size = strlen(message.data);
 
-    Reaction_Test_App_DisplayLcd(g_message, eLcdRow_1, eLcdColumn_1, eLcdOption_None);
+    Reaction_Test_App_DisplayUart(message);
 
+    // Init shows the feedback once the modules are reset, it blinks on its own while the FSM waits for START
+    g_game_error = error;
     g_reaction_test_state = eReactionTestState_Init;
 
-    osDelay(5000);
-
     return;
 }
 
@@ -6,7 +6,10 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "framework_config.h"
 #include "lcd_api.h"
+#include "accuracy_score.h"
+#include "session_arena.h"
 
 /**********************************************************************************************************************
  * Exported definitions and macros
@@ -17,22 +20,35 @@
 #define MAX_START_DELAY 5000
 
 #define DEFAULT_HAND_OFFSET 50
-#define DEFAULT_DISTANCE_THRESHOLD_MM 10
-#define ACCURACY_SIGMA 100
 
 #define UART_MESSAGE_SIZE 64
 #define LCD_MESSAGE_SIZE 16
 
+#define MAX_MODULES 16
+#define MODULE_COUNT_ONE(id, vl53l0x, ws2812b, port, pin, mux_channel) + 1
+#define MODULE_COUNT (0 REACTION_MODULE_LIST(MODULE_COUNT_ONE))
+
+#if (MODULE_COUNT == 0) || (MODULE_COUNT > MAX_MODULES)
+#error "REACTION_MODULE_LIST must hold 1 to MAX_MODULES modules"
+#endif
+
+/// Module sets are bitmasks, one bit per eModule_t
+#define MODULE_MASK(module) (1UL << (module))
+#define ALL_MODULES_MASK (MODULE_MASK(eModule_Last) - 1UL)
+/// Lowest module in a non-empty mask
+#define MODULE_MASK_LOWEST(mask) ((eModule_t) __builtin_ctz(mask))
+
 /**********************************************************************************************************************
  * Exported types
  *********************************************************************************************************************/
 
 /* clang-format off */
+#define MODULE_ENUM(id, vl53l0x, ws2812b, port, pin, mux_channel) eModule_##id,
+
 typedef enum eModule {
-    eModule_First = 0,
-    eModule_1 = eModule_First,
-    eModule_2,
-    eModule_Last
+    REACTION_MODULE_LIST(MODULE_ENUM)
+    eModule_Last,
+    eModule_First = 0
 } eModule_t;
 
 typedef enum sModuleState {
@@ -56,6 +72,7 @@ typedef enum eGameError {
 } eGameError_t;
 
 typedef struct sGameModeInstance {
+    sSessionArena_t *session_arena;
     void *game_mode_data;
     bool (*game_mode_start)(void *context);
     void (*game_mode_process)(void *context);
@@ -82,8 +99,8 @@ uint16_t Reaction_Test_App_GetTargetDistanceMm (const eModule_t module_data);
 bool Reaction_Test_App_ActiveteModule (const eModule_t module_data, const sModuleState_t state);
 bool Reaction_Test_App_StartDelayTimer (const eModule_t module_data, const uint32_t delay);
 bool Reaction_Test_App_DisplayUart (const sMessage_t message);
+bool Reaction_Test_App_ClearLcd (void);
 bool Reaction_Test_App_DisplayLcd (const sMessage_t message, const eLcdRow_t row, const eLcdColumn_t column, const eLcdOption_t option);
-bool Reaction_Test_WaitForClear (const eModule_t module);
 void Reaction_Test_HandleGameError (eGameError_t error);
 bool Reaction_Test_IsCorrectModule (const eModule_t module);
 
@@ -0,0 +1,682 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "results_log.h"
+
+#ifdef USE_RESULTS_LOG
+
+#include <stddef.h>
+#include <string.h>
+#include "cmsis_os.h"
+#include "stm32f4xx_hal.h"
+#include "debug_api.h"
+#include "timestamp.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_RESULTS_LOG
+
+#define RESULTS_LOG_SECTOR_SIZE (128UL * 1024UL)
+#define RESULTS_LOG_SLOT_SIZE sizeof(sResultsLogRecord_t)
+/// Slot 0 of every sector holds the sector header
+#define RESULTS_LOG_SLOTS (RESULTS_LOG_SECTOR_SIZE / RESULTS_LOG_SLOT_SIZE)
+#define RESULTS_LOG_RECORD_WORDS (RESULTS_LOG_SLOT_SIZE / sizeof(uint32_t))
+#define RESULTS_LOG_MAGIC 0x4C55584CUL
+#define RESULTS_LOG_ERASED 0xFFFFFFFFUL
+/// Session word of a slot whose write failed, programmed over it so the written slots stay contiguous
+#define RESULTS_LOG_INVALID 0x00000000UL
+
+#define RESULTS_LOG_QUEUE_SIZE 32
+#define RESULTS_LOG_FLUSH_FLAG 0x01U
+#define RESULTS_LOG_REPORT_SESSIONS 3
+/// One full queue still fits in the current sector once the next one is erased ahead of time
+#define RESULTS_LOG_PREERASE_SLOTS (RESULTS_LOG_QUEUE_SIZE * 2)
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+typedef enum eResultsLogSector {
+    eResultsLogSector_First = 0,
+    eResultsLogSector_1 = eResultsLogSector_First,
+    eResultsLogSector_2,
+    eResultsLogSector_Last
+} eResultsLogSector_t;
+
+typedef enum eResultsLogRecordType {
+    eResultsLogRecordType_First = 0,
+    eResultsLogRecordType_SectorHeader = eResultsLogRecordType_First,
+    eResultsLogRecordType_Session,
+    eResultsLogRecordType_Trial,
+    eResultsLogRecordType_Last
+} eResultsLogRecordType_t;
+
+typedef struct sResultsLogSectorDesc {
+    uint32_t address;
+    uint32_t sector;
+} sResultsLogSectorDesc_t;
+
+/// One fixed size flash slot, the session word is programmed first and the CRC last
+typedef struct sResultsLogRecord {
+    uint32_t session;
+    uint8_t type;
+    uint8_t reserved[3];
+    union {
+        sResultsLogSession_t session;
+        sResultsLogTrial_t trial;
+        uint32_t generation;
+        uint32_t words[5];
+    } data;
+    uint32_t crc;
+} sResultsLogRecord_t;
+
+_Static_assert(sizeof(sResultsLogRecord_t) == 32, "Results log record must fill one 32 byte slot");
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_RESULTS_LOG
+CREATE_MODULE_NAME (RESULTS_LOG)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/* clang-format off */
+/// Must match the RESULTS_LOG region in STM32F411RETX_FLASH.ld
+static const sResultsLogSectorDesc_t g_static_results_log_sector_lut[eResultsLogSector_Last] = {
+    [eResultsLogSector_1] = {
+        .address = 0x08040000UL,
+        .sector = FLASH_SECTOR_6
+    },
+    [eResultsLogSector_2] = {
+        .address = 0x08060000UL,
+        .sector = FLASH_SECTOR_7
+    }
+};
+
+static const uint32_t g_static_crc_nibble_lut[16] = {
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL, 0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL, 0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+};
+
+const static osThreadAttr_t g_results_log_thread_attributes = {
+    .name = "Results_Log_Thread",
+    .stack_size = 256 * 4,
+    .priority = (osPriority_t) osPriorityLow
+};
+
+const static osMessageQueueAttr_t g_results_log_queue_attributes = {
+    .name = "Results_Log_Queue",
+    .attr_bits = 0,
+    .cb_mem = NULL,
+    .cb_size = 0,
+    .mq_mem = NULL,
+    .mq_size = 0
+};
+
+const static osMutexAttr_t g_results_log_mutex_attributes = {
+    .name = "Results_Log_Mutex",
+    .attr_bits = osMutexPrioInherit,
+    .cb_mem = NULL,
+    .cb_size = 0
+};
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+extern uint32_t _results_log_start;
+
+static bool g_is_initialized = false;
+static osThreadId_t g_results_log_thread_id = NULL;
+static osMessageQueueId_t g_results_log_queue = NULL;
+static osMutexId_t g_results_log_mutex = NULL;
+
+static volatile bool g_is_mounted = false;
+static volatile uint32_t g_next_session = 1;
+static volatile uint32_t g_dropped_records = 0;
+
+/// Generation 0 marks a sector without a valid header
+static uint32_t g_sector_generation[eResultsLogSector_Last] = {0};
+static eResultsLogSector_t g_current_sector = eResultsLogSector_First;
+static uint32_t g_head_slot = RESULTS_LOG_SLOTS;
+/// Writes only run while the app is idle, a suspend stops the writer at the next record
+static volatile bool g_is_writing_allowed = false;
+static bool g_is_next_sector_erased = false;
+
+#ifdef ENABLE_BENCHMARK
+static uint32_t g_erase_time_us = 0;
+#endif
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static void Results_Log_Thread (void *arg);
+static uint32_t Results_Log_Crc (const uint32_t *words, const uint32_t count);
+static const sResultsLogRecord_t *Results_Log_GetSlot (const eResultsLogSector_t sector, const uint32_t slot);
+static bool Results_Log_IsValid (const sResultsLogRecord_t *record);
+static eResultsLogSector_t Results_Log_OtherSector (const eResultsLogSector_t sector);
+static uint32_t Results_Log_FindHead (const eResultsLogSector_t sector);
+static bool Results_Log_ProgramWord (const uint32_t address, const uint32_t word);
+static bool Results_Log_Program (const eResultsLogSector_t sector, const uint32_t slot, sResultsLogRecord_t *record);
+static bool Results_Log_Erase (const eResultsLogSector_t sector);
+static bool Results_Log_Format (const eResultsLogSector_t sector, const uint32_t generation);
+static void Results_Log_PreErase (void);
+static bool Results_Log_Mount (void);
+static bool Results_Log_Write (sResultsLogRecord_t *record);
+static uint32_t Results_Log_GetRecordCount (void);
+static const sResultsLogRecord_t *Results_Log_GetRecord (const uint32_t index);
+static uint32_t Results_Log_GetSession (const uint32_t index);
+/// Session of the nearest valid record at or before index, failed slots carry no usable number
+static uint32_t Results_Log_GetSession (const uint32_t index) {
+    for (uint32_t current = index + 1; current > 0; current--) {
+        const sResultsLogRecord_t *record = Results_Log_GetRecord(current - 1);
+
+        if (Results_Log_IsValid(record)) {
+            return record->session;
+        }
+    }
+
+    return 0;
+}
+
+static bool Results_Log_Enqueue (const eResultsLogRecordType_t type, const void *data, const uint32_t size, const uint32_t session);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static void Results_Log_Thread (void *arg) {
+    sResultsLogRecord_t record;
+    uint32_t reported_dropped = 0;
+
+    osMutexAcquire(g_results_log_mutex, osWaitForever);
+
+    bool is_mounted = Results_Log_Mount();
+
+    osMutexRelease(g_results_log_mutex);
+
+    if (!is_mounted) {
+        TRACE_ERR("Failed to mount results log\n");
+
+        osThreadTerminate(g_results_log_thread_id);
+
+        return;
+    }
+
+    g_is_mounted = true;
+
+    sResultsLogSession_t sessions[RESULTS_LOG_REPORT_SESSIONS];
+    uint8_t sessions_count = Results_Log_GetLastSessions(sessions, RESULTS_LOG_REPORT_SESSIONS);
+
+    for (uint8_t session = 0; session < sessions_count; session++) {
+        TRACE_INFO("Logged session: %u trials, avg %lu us, median %lu us, acc %u\n", sessions[session].trials, sessions[session].mean_reaction_time, sessions[session].median_reaction_time, sessions[session].average_accuracy);
+    }
+
+    while (1) {
+        // Flash stalls every fetch while it programs or erases, so records only go out once the app is idle
+        osThreadFlagsWait(RESULTS_LOG_FLUSH_FLAG, osFlagsWaitAny, osWaitForever);
+
+#ifdef ENABLE_BENCHMARK
+        uint32_t written_records = 0;
+        uint32_t flush_start = Timestamp_GetUs();
+
+        g_erase_time_us = 0;
+#endif
+
+        Results_Log_PreErase();
+
+        while (g_is_writing_allowed && (osMessageQueueGet(g_results_log_queue, &record, NULL, 0U) == osOK)) {
+            osMutexAcquire(g_results_log_mutex, osWaitForever);
+
+            bool is_written = Results_Log_Write(&record);
+
+            osMutexRelease(g_results_log_mutex);
+
+            if (!is_written) {
+                TRACE_ERR("Failed to write results log record\n");
+
+                continue;
+            }
+
+#ifdef ENABLE_BENCHMARK
+            written_records++;
+#endif
+        }
+
+        // Records left in the queue wait for the next idle flush
+        Results_Log_PreErase();
+
+#ifdef ENABLE_BENCHMARK
+        if (written_records > 0) {
+            TRACE_INFO("Results log: %lu records in %lu us, erase %lu us, %lu B stack unused\n", written_records, Timestamp_ElapsedUs(flush_start, Timestamp_GetUs()), g_erase_time_us, osThreadGetStackSpace(g_results_log_thread_id));
+        }
+#endif
+
+        if (g_dropped_records != reported_dropped) {
+            reported_dropped = g_dropped_records;
+
+            TRACE_WRN("Results log dropped %lu records\n", reported_dropped);
+        }
+    }
+}
+
+static uint32_t Results_Log_Crc (const uint32_t *words, const uint32_t count) {
+    const uint8_t *bytes = (const uint8_t *) words;
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    for (uint32_t index = 0; index < (count * sizeof(uint32_t)); index++) {
+        crc ^= bytes[index];
+        crc = (crc >> 4) ^ g_static_crc_nibble_lut[crc & 0x0F];
+        crc = (crc >> 4) ^ g_static_crc_nibble_lut[crc & 0x0F];
+    }
+
+    return ~crc;
+}
+
+static const sResultsLogRecord_t *Results_Log_GetSlot (const eResultsLogSector_t sector, const uint32_t slot) {
+    return (const sResultsLogRecord_t *) (g_static_results_log_sector_lut[sector].address + (slot * RESULTS_LOG_SLOT_SIZE));
+}
+
+static bool Results_Log_IsValid (const sResultsLogRecord_t *record) {
+    return Results_Log_Crc((const uint32_t *) record, RESULTS_LOG_RECORD_WORDS - 1) == record->crc;
+}
+
+static eResultsLogSector_t Results_Log_OtherSector (const eResultsLogSector_t sector) {
+    return (sector == eResultsLogSector_1) ? eResultsLogSector_2 : eResultsLogSector_1;
+}
+
+static uint32_t Results_Log_FindHead (const eResultsLogSector_t sector) {
+    uint32_t low = 1;
+    uint32_t high = RESULTS_LOG_SLOTS;
+
+    // Slots fill in order and failed ones are marked, so the first erased one splits the sector in two
+    while (low < high) {
+        uint32_t middle = (low + high) / 2;
+
+        if (Results_Log_GetSlot(sector, middle)->session == RESULTS_LOG_ERASED) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+
+    return low;
+}
+
+static bool Results_Log_ProgramWord (const uint32_t address, const uint32_t word) {
+    HAL_FLASH_Unlock();
+
+    HAL_StatusTypeDef status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word);
+
+    HAL_FLASH_Lock();
+
+    return (status == HAL_OK);
+}
+
+static bool Results_Log_Program (const eResultsLogSector_t sector, const uint32_t slot, sResultsLogRecord_t *record) {
+    const uint32_t *words = (const uint32_t *) record;
+    uint32_t address = (uint32_t) Results_Log_GetSlot(sector, slot);
+    bool is_programmed = true;
+
+    record->crc = Results_Log_Crc(words, RESULTS_LOG_RECORD_WORDS - 1);
+
+    HAL_FLASH_Unlock();
+
+    for (uint32_t word = 0; word < RESULTS_LOG_RECORD_WORDS; word++) {
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address + (word * sizeof(uint32_t)), words[word]) != HAL_OK) {
+            is_programmed = false;
+
+            break;
+        }
+    }
+
+    HAL_FLASH_Lock();
+
+    return is_programmed;
+}
+
+static bool Results_Log_Erase (const eResultsLogSector_t sector) {
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_SECTORS,
+        .Sector = g_static_results_log_sector_lut[sector].sector,
+        .NbSectors = 1,
+        .VoltageRange = FLASH_VOLTAGE_RANGE_3
+    };
+    uint32_t sector_error = 0;
+
+#ifdef ENABLE_BENCHMARK
+    uint32_t erase_start = Timestamp_GetUs();
+#endif
+
+    HAL_FLASH_Unlock();
+
+    HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &sector_error);
+
+    HAL_FLASH_Lock();
+
+#ifdef ENABLE_BENCHMARK
+    g_erase_time_us += Timestamp_ElapsedUs(erase_start, Timestamp_GetUs());
+#endif
+
+    g_sector_generation[sector] = 0;
+
+    if (status != HAL_OK) {
+        TRACE_ERR("Failed to erase results log sector [%d]\n", sector);
+
+        return false;
+    }
+
+    return true;
+}
+
+/// Skips the erase when the sector was already erased ahead of time
+static bool Results_Log_Format (const eResultsLogSector_t sector, const uint32_t generation) {
+    bool is_erased = g_is_next_sector_erased && (sector == Results_Log_OtherSector(g_current_sector));
+
+    g_is_next_sector_erased = false;
+
+    if (!is_erased && !Results_Log_Erase(sector)) {
+        return false;
+    }
+
+    sResultsLogRecord_t header = {.session = RESULTS_LOG_MAGIC, .type = eResultsLogRecordType_SectorHeader};
+
+    header.data.generation = generation;
+
+    if (!Results_Log_Program(sector, 0, &header)) {
+        TRACE_ERR("Failed to write results log sector [%d] header\n", sector);
+
+        return false;
+    }
+
+    g_sector_generation[sector] = generation;
+
+    return true;
+}
+
+/// Erases the next sector while the app is idle, so a rotation never lands in a measurement
+static void Results_Log_PreErase (void) {
+    if (!g_is_writing_allowed || g_is_next_sector_erased || ((g_head_slot + RESULTS_LOG_PREERASE_SLOTS) < RESULTS_LOG_SLOTS)) {
+        return;
+    }
+
+    osMutexAcquire(g_results_log_mutex, osWaitForever);
+
+    // The oldest results go a little earlier than the rotation would take them
+    g_is_next_sector_erased = Results_Log_Erase(Results_Log_OtherSector(g_current_sector));
+
+    osMutexRelease(g_results_log_mutex);
+
+    return;
+}
+
+static bool Results_Log_Mount (void) {
+    for (eResultsLogSector_t sector = eResultsLogSector_First; sector < eResultsLogSector_Last; sector++) {
+        const sResultsLogRecord_t *header = Results_Log_GetSlot(sector, 0);
+
+        g_sector_generation[sector] = 0;
+
+        if ((header->session == RESULTS_LOG_MAGIC) && (header->type == eResultsLogRecordType_SectorHeader) && Results_Log_IsValid(header)) {
+            g_sector_generation[sector] = header->data.generation;
+        }
+    }
+
+    if ((g_sector_generation[eResultsLogSector_1] == 0) && (g_sector_generation[eResultsLogSector_2] == 0)) {
+        TRACE_INFO("Formatting results log\n");
+
+        g_current_sector = eResultsLogSector_1;
+        g_head_slot = 1;
+
+        return Results_Log_Format(g_current_sector, 1);
+    }
+
+    if (g_sector_generation[eResultsLogSector_2] > g_sector_generation[eResultsLogSector_1]) {
+        g_current_sector = eResultsLogSector_2;
+    } else {
+        g_current_sector = eResultsLogSector_1;
+    }
+
+    g_head_slot = Results_Log_FindHead(g_current_sector);
+
+    // Numbers only advance with a summary, trials of an unfinished session share the next number
+    for (uint32_t index = Results_Log_GetRecordCount(); index > 0; index--) {
+        const sResultsLogRecord_t *record = Results_Log_GetRecord(index - 1);
+
+        if ((record->type == eResultsLogRecordType_Session) && Results_Log_IsValid(record)) {
+            g_next_session = record->session + 1;
+
+            break;
+        }
+    }
+
+    return true;
+}
+
+static bool Results_Log_Write (sResultsLogRecord_t *record) {
+    if (g_head_slot >= RESULTS_LOG_SLOTS) {
+        // Sectors are erased in turn, so wear spreads evenly and the oldest results go first
+        eResultsLogSector_t next_sector = Results_Log_OtherSector(g_current_sector);
+
+        if (!Results_Log_Format(next_sector, g_sector_generation[g_current_sector] + 1)) {
+            return false;
+        }
+
+        g_current_sector = next_sector;
+        g_head_slot = 1;
+    }
+
+    if (!Results_Log_Program(g_current_sector, g_head_slot, record)) {
+        // A partly programmed slot is skipped by its CRC, never reuse it. Clearing its session word keeps it from
+        // reading as erased, a hole would split the written slots for the head search on the next mount
+        if (!Results_Log_ProgramWord((uint32_t) &Results_Log_GetSlot(g_current_sector, g_head_slot)->session, RESULTS_LOG_INVALID)) {
+            TRACE_ERR("Failed to mark results log slot [%lu], rotating sector\n", g_head_slot);
+
+            // Nothing may follow an unmarked hole in this sector
+            g_head_slot = RESULTS_LOG_SLOTS;
+
+            return false;
+        }
+
+        g_head_slot++;
+
+        return false;
+    }
+
+    g_head_slot++;
+
+    return true;
+}
+
+static uint32_t Results_Log_GetRecordCount (void) {
+    eResultsLogSector_t older_sector = Results_Log_OtherSector(g_current_sector);
+    uint32_t count = g_head_slot - 1;
+
+    if ((g_sector_generation[older_sector] != 0) && (g_sector_generation[older_sector] < g_sector_generation[g_current_sector])) {
+        count += RESULTS_LOG_SLOTS - 1;
+    }
+
+    return count;
+}
+
+/// Index 0 is the oldest record still in flash
+static const sResultsLogRecord_t *Results_Log_GetRecord (const uint32_t index) {
+    eResultsLogSector_t older_sector = Results_Log_OtherSector(g_current_sector);
+    uint32_t current_index = index;
+
+    if ((g_sector_generation[older_sector] != 0) && (g_sector_generation[older_sector] < g_sector_generation[g_current_sector])) {
+        if (index < (RESULTS_LOG_SLOTS - 1)) {
+            return Results_Log_GetSlot(older_sector, index + 1);
+        }
+
+        current_index -= RESULTS_LOG_SLOTS - 1;
+    }
+
+    return Results_Log_GetSlot(g_current_sector, current_index + 1);
+}
+
+static bool Results_Log_Enqueue (const eResultsLogRecordType_t type, const void *data, const uint32_t size, const uint32_t session) {
+    if (!g_is_initialized || !g_is_mounted || (data == NULL)) {
+        g_dropped_records++;
+
+        return false;
+    }
+
+    sResultsLogRecord_t record;
+
+    memset(&record, 0, sizeof(record));
+
+    record.session = session;
+    record.type = type;
+
+    memcpy(&record.data, data, size);
+
+    // Never wait here, the caller may be on the measurement path
+    if (osMessageQueuePut(g_results_log_queue, &record, 0U, 0U) != osOK) {
+        g_dropped_records++;
+
+        return false;
+    }
+
+    return true;
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Results_Log_Init (void) {
+    if (g_is_initialized) {
+        return true;
+    }
+
+    if ((uint32_t) &_results_log_start != g_static_results_log_sector_lut[eResultsLogSector_First].address) {
+        TRACE_ERR("Failed to init results log: Linker region mismatch\n");
+
+        return false;
+    }
+
+    g_results_log_mutex = osMutexNew(&g_results_log_mutex_attributes);
+
+    if (g_results_log_mutex == NULL) {
+        TRACE_ERR("Failed to create results log mutex\n");
+
+        return false;
+    }
+
+    g_results_log_queue = osMessageQueueNew(RESULTS_LOG_QUEUE_SIZE, sizeof(sResultsLogRecord_t), &g_results_log_queue_attributes);
+
+    if (g_results_log_queue == NULL) {
+        TRACE_ERR("Failed to create results log queue\n");
+
+        return false;
+    }
+
+    g_results_log_thread_id = osThreadNew(Results_Log_Thread, NULL, &g_results_log_thread_attributes);
+
+    if (g_results_log_thread_id == NULL) {
+        TRACE_ERR("Failed to create results log thread\n");
+
+        return false;
+    }
+
+    g_is_initialized = true;
+
+    return true;
+}
+
+bool Results_Log_AppendTrial (const sResultsLogTrial_t *trial) {
+    return Results_Log_Enqueue(eResultsLogRecordType_Trial, trial, sizeof(sResultsLogTrial_t), g_next_session);
+}
+
+bool Results_Log_AppendSession (const sResultsLogSession_t *session) {
+    bool is_appended = Results_Log_Enqueue(eResultsLogRecordType_Session, session, sizeof(sResultsLogSession_t), g_next_session);
+
+    // Trials of the next session must not share the number, even if this summary was dropped
+    g_next_session++;
+
+    return is_appended;
+}
+
+/// Called by the app when it enters Idle or Pause
+void Results_Log_Resume (void) {
+    g_is_writing_allowed = true;
+
+    return;
+}
+
+/// Called by the app when it leaves Idle, the writer stops before its next record or erase
+void Results_Log_Suspend (void) {
+    g_is_writing_allowed = false;
+
+    return;
+}
+
+/// Rejected unless the app has resumed the log
+bool Results_Log_Flush (void) {
+    if (!g_is_initialized || !g_is_writing_allowed) {
+        return false;
+    }
+
+    osThreadFlagsSet(g_results_log_thread_id, RESULTS_LOG_FLUSH_FLAG);
+
+    return true;
+}
+
+/// Returns up to count summaries of the newest sessions, oldest first
+uint8_t Results_Log_GetLastSessions (sResultsLogSession_t *sessions, const uint8_t count) {
+    if (!g_is_mounted || (sessions == NULL) || (count == 0)) {
+        return 0;
+    }
+
+    uint8_t found = 0;
+    uint32_t first_session = 1;
+
+    if (g_next_session > count) {
+        first_session = g_next_session - count;
+    }
+
+    osMutexAcquire(g_results_log_mutex, osWaitForever);
+
+    uint32_t total = Results_Log_GetRecordCount();
+    uint32_t low = 0;
+    uint32_t high = total;
+
+    // Session numbers of valid records only grow along the log, so the first record of the oldest wanted session is a binary search away
+    while (low < high) {
+        uint32_t middle = (low + high) / 2;
+
+        if (Results_Log_GetSession(middle) < first_session) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    for (uint32_t index = low; (index < total) && (found < count); index++) {
+        const sResultsLogRecord_t *record = Results_Log_GetRecord(index);
+
+        if ((record->type != eResultsLogRecordType_Session) || !Results_Log_IsValid(record)) {
+            continue;
+        }
+
+        sessions[found] = record->data.session;
+        found++;
+    }
+
+    osMutexRelease(g_results_log_mutex);
+
+    return found;
+}
+
+#endif /* USE_RESULTS_LOG */
@@ -0,0 +1,58 @@
+#ifndef SOURCE_APP_RESULTS_LOG_H_
+#define SOURCE_APP_RESULTS_LOG_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "framework_config.h"
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/* clang-format off */
+typedef struct sResultsLogSession {
+    uint32_t mean_reaction_time;        // us
+    uint32_t reaction_time_deviation;   // us
+    uint32_t median_reaction_time;      // us
+    uint32_t p95_reaction_time;         // us
+    uint16_t trials;
+    uint8_t average_accuracy;
+    uint8_t difficulty;
+} sResultsLogSession_t;
+
+typedef struct sResultsLogTrial {
+    uint32_t reaction_time;             // us
+    uint16_t target_distance;           // mm
+    uint16_t registered_distance;       // mm
+    uint8_t accuracy;
+    uint8_t attempt;
+    uint8_t reserved[2];
+} sResultsLogTrial_t;
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+#ifdef USE_RESULTS_LOG
+bool Results_Log_Init (void);
+bool Results_Log_AppendTrial (const sResultsLogTrial_t *trial);
+bool Results_Log_AppendSession (const sResultsLogSession_t *session);
+void Results_Log_Resume (void);
+void Results_Log_Suspend (void);
+bool Results_Log_Flush (void);
+uint8_t Results_Log_GetLastSessions (sResultsLogSession_t *sessions, const uint8_t count);
+#endif
+
+#endif /* SOURCE_APP_RESULTS_LOG_H_ */
@@ -0,0 +1,244 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "sensor_exti.h"
+
+#ifdef USE_VL53L0X_DATA_READY
+
+#include <stddef.h>
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_gpio.h"
+#include "stm32f4xx_ll_exti.h"
+#include "stm32f4xx_ll_system.h"
+#include "debug_api.h"
+#include "timestamp.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_SENSOR_EXTI
+
+/// Must stay numerically >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, the callback uses RTOS FromISR calls
+#define SENSOR_EXTI_IRQ_PRIORITY 6
+
+/// EXTI lines used by the module list, one per data-ready pin number
+#define SENSOR_EXTI_LINE_BIT(id, vl53l0x, ws2812b, port, pin, mux_channel) | (1UL << (pin))
+#define SENSOR_EXTI_LINE_SUM(id, vl53l0x, ws2812b, port, pin, mux_channel) + (1UL << (pin))
+#define SENSOR_EXTI_LINES (0 REACTION_MODULE_LIST(SENSOR_EXTI_LINE_BIT))
+
+#if (0 REACTION_MODULE_LIST(SENSOR_EXTI_LINE_SUM)) != SENSOR_EXTI_LINES
+#error "Data-ready pins of two modules share an EXTI line"
+#endif
+
+/// EXTI0 and EXTI1 handlers are defined by the framework IO driver
+#if (SENSOR_EXTI_LINES & 0x0003UL)
+#error "Data-ready pins must not use EXTI line 0 or 1"
+#endif
+
+#define SENSOR_EXTI_IRQ_0 EXTI0_IRQn
+#define SENSOR_EXTI_IRQ_1 EXTI1_IRQn
+#define SENSOR_EXTI_IRQ_2 EXTI2_IRQn
+#define SENSOR_EXTI_IRQ_3 EXTI3_IRQn
+#define SENSOR_EXTI_IRQ_4 EXTI4_IRQn
+#define SENSOR_EXTI_IRQ_5 EXTI9_5_IRQn
+#define SENSOR_EXTI_IRQ_6 EXTI9_5_IRQn
+#define SENSOR_EXTI_IRQ_7 EXTI9_5_IRQn
+#define SENSOR_EXTI_IRQ_8 EXTI9_5_IRQn
+#define SENSOR_EXTI_IRQ_9 EXTI9_5_IRQn
+#define SENSOR_EXTI_IRQ_10 EXTI15_10_IRQn
+#define SENSOR_EXTI_IRQ_11 EXTI15_10_IRQn
+#define SENSOR_EXTI_IRQ_12 EXTI15_10_IRQn
+#define SENSOR_EXTI_IRQ_13 EXTI15_10_IRQn
+#define SENSOR_EXTI_IRQ_14 EXTI15_10_IRQn
+#define SENSOR_EXTI_IRQ_15 EXTI15_10_IRQn
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+typedef struct sSensorExtiDesc {
+    GPIO_TypeDef *port;
+    uint32_t pin;
+    uint32_t clock;
+    uint32_t syscfg_port;
+    uint32_t syscfg_line;
+    uint32_t exti_line;
+    IRQn_Type irq;
+} sSensorExtiDesc_t;
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_SENSOR_EXTI
+CREATE_MODULE_NAME (SENSOR_EXTI)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/* clang-format off */
+#define SENSOR_EXTI_DESC(id, vl53l0x, ws2812b, gpio_port, gpio_pin, mux_channel) \
+    [eModule_##id] = {                                              \
+        .port = GPIO##gpio_port,                                    \
+        .pin = LL_GPIO_PIN_##gpio_pin,                              \
+        .clock = LL_AHB1_GRP1_PERIPH_GPIO##gpio_port,               \
+        .syscfg_port = LL_SYSCFG_EXTI_PORT##gpio_port,              \
+        .syscfg_line = LL_SYSCFG_EXTI_LINE##gpio_pin,               \
+        .exti_line = LL_EXTI_LINE_##gpio_pin,                       \
+        .irq = SENSOR_EXTI_IRQ_##gpio_pin                           \
+    },
+
+#define SENSOR_EXTI_LINE_MODULE(id, vl53l0x, ws2812b, gpio_port, gpio_pin, mux_channel) [gpio_pin] = eModule_##id,
+
+/// VL53L0X GPIO1 is active-low, it is asserted on new sample and released on interrupt clear
+static const sSensorExtiDesc_t g_static_sensor_exti_lut[eModule_Last] = {
+    REACTION_MODULE_LIST(SENSOR_EXTI_DESC)
+};
+
+static const eModule_t g_static_sensor_exti_line_lut[16] = {
+    REACTION_MODULE_LIST(SENSOR_EXTI_LINE_MODULE)
+};
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static bool g_is_initialized = false;
+static sensor_exti_callback_t g_callback = NULL;
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static void Sensor_Exti_IrqHandler (void);
+
+void EXTI2_IRQHandler (void);
+void EXTI3_IRQHandler (void);
+void EXTI4_IRQHandler (void);
+void EXTI9_5_IRQHandler (void);
+void EXTI15_10_IRQHandler (void);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static void Sensor_Exti_IrqHandler (void) {
+    uint32_t timestamp = Timestamp_GetUs();
+    uint32_t pending = LL_EXTI_ReadFlag_0_31(SENSOR_EXTI_LINES);
+
+    LL_EXTI_ClearFlag_0_31(pending);
+
+    // Only lines that fired are visited, however many modules share the handler
+    for (; (pending != 0) && (g_callback != NULL); pending &= pending - 1) {
+        g_callback(g_static_sensor_exti_line_lut[__builtin_ctz(pending)], timestamp);
+    }
+}
+
+/// Handlers exist only for the lines in the module list, the rest stay free for other drivers
+#if (SENSOR_EXTI_LINES & 0x0004UL)
+void EXTI2_IRQHandler (void) {
+    Sensor_Exti_IrqHandler();
+}
+#endif
+
+#if (SENSOR_EXTI_LINES & 0x0008UL)
+void EXTI3_IRQHandler (void) {
+    Sensor_Exti_IrqHandler();
+}
+#endif
+
+#if (SENSOR_EXTI_LINES & 0x0010UL)
+void EXTI4_IRQHandler (void) {
+    Sensor_Exti_IrqHandler();
+}
+#endif
+
+#if (SENSOR_EXTI_LINES & 0x03E0UL)
+void EXTI9_5_IRQHandler (void) {
+    Sensor_Exti_IrqHandler();
+}
+#endif
+
+#if (SENSOR_EXTI_LINES & 0xFC00UL)
+void EXTI15_10_IRQHandler (void) {
+    Sensor_Exti_IrqHandler();
+}
+#endif
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Sensor_Exti_Init (sensor_exti_callback_t callback) {
+    if (g_is_initialized) {
+        return true;
+    }
+
+    if (callback == NULL) {
+        TRACE_ERR("Failed to init sensor EXTI: Invalid callback\n");
+
+        return false;
+    }
+
+    g_callback = callback;
+
+    for (eModule_t module = eModule_First; module < eModule_Last; module++) {
+        const sSensorExtiDesc_t *desc = &g_static_sensor_exti_lut[module];
+
+        LL_AHB1_GRP1_EnableClock(desc->clock);
+
+        LL_GPIO_SetPinMode(desc->port, desc->pin, LL_GPIO_MODE_INPUT);
+        LL_GPIO_SetPinPull(desc->port, desc->pin, LL_GPIO_PULL_UP);
+
+        LL_SYSCFG_SetEXTISource(desc->syscfg_port, desc->syscfg_line);
+
+        LL_EXTI_DisableIT_0_31(desc->exti_line);
+        LL_EXTI_EnableFallingTrig_0_31(desc->exti_line);
+        LL_EXTI_ClearFlag_0_31(desc->exti_line);
+
+        NVIC_SetPriority(desc->irq, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), SENSOR_EXTI_IRQ_PRIORITY, 0));
+        NVIC_EnableIRQ(desc->irq);
+    }
+
+    g_is_initialized = true;
+
+    return true;
+}
+
+bool Sensor_Exti_Enable (const eModule_t module) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module)) {
+        return false;
+    }
+
+    const sSensorExtiDesc_t *desc = &g_static_sensor_exti_lut[module];
+
+    LL_EXTI_ClearFlag_0_31(desc->exti_line);
+    LL_EXTI_EnableIT_0_31(desc->exti_line);
+
+    // A sample left uncleared keeps GPIO1 low and no further falling edge would follow
+    if (!LL_GPIO_IsInputPinSet(desc->port, desc->pin)) {
+        LL_EXTI_GenerateSWI_0_31(desc->exti_line);
+    }
+
+    return true;
+}
+
+bool Sensor_Exti_Disable (const eModule_t module) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module)) {
+        return false;
+    }
+
+    LL_EXTI_DisableIT_0_31(g_static_sensor_exti_lut[module].exti_line);
+    LL_EXTI_ClearFlag_0_31(g_static_sensor_exti_lut[module].exti_line);
+
+    return true;
+}
+
+#endif /* USE_VL53L0X_DATA_READY */
@@ -0,0 +1,37 @@
+#ifndef SOURCE_APP_SENSOR_EXTI_H_
+#define SOURCE_APP_SENSOR_EXTI_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "framework_config.h"
+#include "reaction_test_app.h"
+
+#ifdef USE_VL53L0X_DATA_READY
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+typedef void (*sensor_exti_callback_t) (const eModule_t module, const uint32_t timestamp);
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Sensor_Exti_Init (sensor_exti_callback_t callback);
+bool Sensor_Exti_Enable (const eModule_t module);
+bool Sensor_Exti_Disable (const eModule_t module);
+
+#endif /* USE_VL53L0X_DATA_READY */
+#endif /* SOURCE_APP_SENSOR_EXTI_H_ */
@@ -0,0 +1,121 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "sensor_mux.h"
+#include <stddef.h>
+#include <string.h>
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+/// Depends only on its arguments, so the scheduler also builds on the host against a simulated mux
+bool Sensor_Mux_Init (sSensorMux_t *mux, const uint8_t *channels, const uint8_t sensors, sensor_mux_select_t select) {
+    if ((mux == NULL) || (channels == NULL) || (sensors == 0) || (sensors > SENSOR_MUX_MAX_SENSORS) || (select == NULL)) {
+        return false;
+    }
+
+    memset(mux, 0, sizeof(sSensorMux_t));
+
+    mux->select = select;
+    mux->sensors = sensors;
+    mux->current_channel = SENSOR_MUX_CHANNEL_NONE;
+
+    for (uint8_t sensor = 0; sensor < sensors; sensor++) {
+        if (channels[sensor] >= SENSOR_MUX_CHANNELS) {
+            return false;
+        }
+
+        mux->sensor_channel[sensor] = channels[sensor];
+        mux->channel_sensors[channels[sensor]] |= 1UL << sensor;
+    }
+
+    return true;
+}
+
+/// Orders the pending sensors channel by channel, starting on the selected one, so a round switches at most once per channel
+uint8_t Sensor_Mux_Schedule (const sSensorMux_t *mux, const uint32_t pending, uint8_t *order) {
+    if ((mux == NULL) || (order == NULL)) {
+        return 0;
+    }
+
+    uint8_t count = 0;
+    uint8_t channel = (mux->current_channel < SENSOR_MUX_CHANNELS) ? mux->current_channel : 0;
+
+    for (uint8_t visited = 0; visited < SENSOR_MUX_CHANNELS; visited++) {
+        for (uint32_t batch = pending & mux->channel_sensors[channel]; batch != 0; batch &= batch - 1) {
+            order[count] = (uint8_t) __builtin_ctz(batch);
+            count++;
+        }
+
+        channel = (channel + 1) % SENSOR_MUX_CHANNELS;
+    }
+
+    return count;
+}
+
+/// Called before every transaction on the sensor, the mux is only written when the channel changes
+bool Sensor_Mux_Select (sSensorMux_t *mux, const uint8_t sensor) {
+    if ((mux == NULL) || (sensor >= mux->sensors)) {
+        return false;
+    }
+
+    uint8_t channel = mux->sensor_channel[sensor];
+
+    mux->transactions++;
+
+    if (channel == mux->current_channel) {
+        return true;
+    }
+
+    if (!mux->select(channel)) {
+        mux->current_channel = SENSOR_MUX_CHANNEL_NONE;
+
+        return false;
+    }
+
+    mux->current_channel = channel;
+    mux->switches++;
+
+    return true;
+}
+
+void Sensor_Mux_ResetStats (sSensorMux_t *mux) {
+    if (mux == NULL) {
+        return;
+    }
+
+    mux->transactions = 0;
+    mux->switches = 0;
+
+    return;
+}
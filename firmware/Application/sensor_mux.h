@@ -0,0 +1,53 @@
+#ifndef SOURCE_APP_SENSOR_MUX_H_
+#define SOURCE_APP_SENSOR_MUX_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/// TCA9548A downstream channels
+#define SENSOR_MUX_CHANNELS 8
+/// Sensor sets are bitmasks, one bit per sensor
+#define SENSOR_MUX_MAX_SENSORS 32
+/// No channel selected yet, or the mux state is unknown after a failed switch
+#define SENSOR_MUX_CHANNEL_NONE 0xFF
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/// Switches the mux to one channel, only called when the channel changes
+typedef bool (*sensor_mux_select_t)(const uint8_t channel);
+
+/* clang-format off */
+typedef struct sSensorMux {
+    sensor_mux_select_t select;
+    uint8_t sensors;
+    uint8_t current_channel;
+    uint8_t sensor_channel[SENSOR_MUX_MAX_SENSORS];
+    uint32_t channel_sensors[SENSOR_MUX_CHANNELS];     // Sensor mask per channel
+    uint32_t transactions;
+    uint32_t switches;
+} sSensorMux_t;
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Sensor_Mux_Init (sSensorMux_t *mux, const uint8_t *channels, const uint8_t sensors, sensor_mux_select_t select);
+uint8_t Sensor_Mux_Schedule (const sSensorMux_t *mux, const uint32_t pending, uint8_t *order);
+bool Sensor_Mux_Select (sSensorMux_t *mux, const uint8_t sensor);
+void Sensor_Mux_ResetStats (sSensorMux_t *mux);
+
+#endif /* SOURCE_APP_SENSOR_MUX_H_ */
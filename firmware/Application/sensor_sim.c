@@ -0,0 +1,224 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "sensor_sim.h"
+
+#ifdef USE_SIMULATED_SENSORS
+
+#include <stddef.h>
+#include "debug_api.h"
+#include "timestamp.h"
+#include "sensor_sim_model.h"
+#ifdef USE_I2C_MUX
+#include "sensor_mux.h"
+#endif
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_SENSOR_SIM
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+typedef struct sSensorSimDynamicDesc {
+    bool is_measuring;
+    bool is_cued;
+    uint32_t cue_time;
+    uint8_t step;
+    uint8_t next_step;
+} sSensorSimDynamicDesc_t;
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_SENSOR_SIM
+CREATE_MODULE_NAME (SENSOR_SIM)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+#ifdef USE_I2C_MUX
+/* clang-format off */
+#define SENSOR_SIM_MUX_CHANNEL(id, vl53l0x, ws2812b, port, pin, mux_channel) [eModule_##id] = mux_channel,
+
+static const uint8_t g_static_sensor_sim_mux_channel_lut[eModule_Last] = {
+    REACTION_MODULE_LIST(SENSOR_SIM_MUX_CHANNEL)
+};
+/* clang-format on */
+#endif
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static bool g_is_initialized = false;
+static sSensorSimDynamicDesc_t g_dynamic_sensor_sim_desc[eModule_Last] = {0};
+#ifdef USE_I2C_MUX
+static uint8_t g_selected_channel = SENSOR_MUX_CHANNEL_NONE;
+#endif
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static uint16_t Sensor_Sim_HandDistance (const eModule_t module, const uint32_t now);
+static bool Sensor_Sim_IsReachable (const eModule_t module);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static uint16_t Sensor_Sim_HandDistance (const eModule_t module, const uint32_t now) {
+    sSensorSimDynamicDesc_t *desc = &g_dynamic_sensor_sim_desc[module];
+
+    if (!desc->is_cued) {
+        return SENSOR_SIM_CLEAR_DISTANCE_MM;
+    }
+
+    return Sensor_Sim_Model_GetDistance(desc->step, Reaction_Test_App_GetTargetDistanceMm(module), Timestamp_ElapsedUs(desc->cue_time, now));
+}
+
+/// Behind a mux only the sensors on the selected channel answer, a read on any other one fails like a NACK would
+static bool Sensor_Sim_IsReachable (const eModule_t module) {
+#ifdef USE_I2C_MUX
+    if (g_selected_channel != g_static_sensor_sim_mux_channel_lut[module]) {
+        TRACE_ERR("Sim [%d]: mux on channel %u, sensor is on %u\n", module, g_selected_channel, g_static_sensor_sim_mux_channel_lut[module]);
+
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Sensor_Sim_Init (void) {
+    if (g_is_initialized) {
+        return true;
+    }
+
+    for (eModule_t module = eModule_First; module < eModule_Last; module++) {
+        g_dynamic_sensor_sim_desc[module].is_measuring = false;
+        g_dynamic_sensor_sim_desc[module].is_cued = false;
+        g_dynamic_sensor_sim_desc[module].step = 0;
+        g_dynamic_sensor_sim_desc[module].next_step = 0;
+    }
+
+    g_is_initialized = true;
+
+    TRACE_INFO("Simulated sensors: %d scripted steps\n", Sensor_Sim_Model_GetStepCount());
+
+    return true;
+}
+
+bool Sensor_Sim_StartMeasuring (const eModule_t module) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module) || !Sensor_Sim_IsReachable(module)) {
+        return false;
+    }
+
+    g_dynamic_sensor_sim_desc[module].is_measuring = true;
+    g_dynamic_sensor_sim_desc[module].is_cued = false;
+
+    return true;
+}
+
+bool Sensor_Sim_StopMeasuring (const eModule_t module) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module) || !Sensor_Sim_IsReachable(module)) {
+        return false;
+    }
+
+    g_dynamic_sensor_sim_desc[module].is_measuring = false;
+    g_dynamic_sensor_sim_desc[module].is_cued = false;
+
+    return true;
+}
+
+bool Sensor_Sim_Cue (const eModule_t module, const uint32_t cue_time) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module)) {
+        return false;
+    }
+
+    sSensorSimDynamicDesc_t *desc = &g_dynamic_sensor_sim_desc[module];
+
+    desc->step = desc->next_step;
+    desc->next_step = (desc->next_step + 1) % Sensor_Sim_Model_GetStepCount();
+    desc->cue_time = cue_time;
+    desc->is_cued = true;
+
+    return true;
+}
+
+/// Checks a scored trial against the scripted step, a mismatch means the measurement or scoring path is broken
+bool Sensor_Sim_CheckTrial (const eModule_t module, const uint16_t registered_distance, const uint32_t reaction_time, const uint8_t accuracy) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module)) {
+        return false;
+    }
+
+    sSensorSimTrial_t expected;
+    bool is_passed = true;
+
+    if (!Sensor_Sim_Model_GetTrial(g_dynamic_sensor_sim_desc[module].step, Reaction_Test_App_GetTargetDistanceMm(module), &expected)) {
+        return false;
+    }
+
+    if (registered_distance != expected.distance) {
+        TRACE_ERR("Sim check [%d]: registered %u mm, expected %u mm\n", module, registered_distance, expected.distance);
+
+        is_passed = false;
+    }
+
+    if ((reaction_time < expected.reaction_time) || (reaction_time > (expected.reaction_time + SENSOR_SIM_REACTION_TOLERANCE_US))) {
+        TRACE_ERR("Sim check [%d]: reaction %lu us, expected %lu us\n", module, reaction_time, expected.reaction_time);
+
+        is_passed = false;
+    }
+
+    if (accuracy != expected.accuracy) {
+        TRACE_ERR("Sim check [%d]: accuracy %u, expected %u\n", module, accuracy, expected.accuracy);
+
+        is_passed = false;
+    }
+
+    return is_passed;
+}
+
+bool Sensor_Sim_GetDistance (const eModule_t module, uint16_t *distance) {
+    if (!g_is_initialized || !Reaction_Test_IsCorrectModule(module) || (distance == NULL) || !Sensor_Sim_IsReachable(module)) {
+        return false;
+    }
+
+    if (!g_dynamic_sensor_sim_desc[module].is_measuring) {
+        return false;
+    }
+
+    *distance = Sensor_Sim_HandDistance(module, Timestamp_GetUs());
+
+    return true;
+}
+
+#ifdef USE_I2C_MUX
+/// Stands in for the TCA9548A control register write
+bool Sensor_Sim_SelectChannel (const uint8_t channel) {
+    if (channel >= SENSOR_MUX_CHANNELS) {
+        return false;
+    }
+
+    g_selected_channel = channel;
+
+    return true;
+}
+#endif
+
+#endif /* USE_SIMULATED_SENSORS */
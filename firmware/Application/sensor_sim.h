@@ -0,0 +1,45 @@
+#ifndef SOURCE_APP_SENSOR_SIM_H_
+#define SOURCE_APP_SENSOR_SIM_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "framework_config.h"
+#include "reaction_test_app.h"
+
+#ifdef USE_SIMULATED_SENSORS
+
+#ifdef USE_VL53L0X_DATA_READY
+#error "USE_SIMULATED_SENSORS has no data-ready line, disable USE_VL53L0X_DATA_READY"
+#endif
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Sensor_Sim_Init (void);
+bool Sensor_Sim_StartMeasuring (const eModule_t module);
+bool Sensor_Sim_StopMeasuring (const eModule_t module);
+bool Sensor_Sim_Cue (const eModule_t module, const uint32_t cue_time);
+bool Sensor_Sim_GetDistance (const eModule_t module, uint16_t *distance);
+bool Sensor_Sim_CheckTrial (const eModule_t module, const uint16_t registered_distance, const uint32_t reaction_time, const uint8_t accuracy);
+#ifdef USE_I2C_MUX
+bool Sensor_Sim_SelectChannel (const uint8_t channel);
+#endif
+
+#endif /* USE_SIMULATED_SENSORS */
+#endif /* SOURCE_APP_SENSOR_SIM_H_ */
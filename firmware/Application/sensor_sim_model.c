@@ -0,0 +1,111 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "sensor_sim_model.h"
+#include <stddef.h>
+#include "accuracy_score.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+typedef struct sSensorSimStep {
+    uint32_t reaction_time_us;
+    uint32_t travel_time_us;
+    int16_t target_error_mm;
+} sSensorSimStep_t;
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/* clang-format off */
+/// Scripted hand movements, each cue on a module takes the next step
+static const sSensorSimStep_t g_static_sensor_sim_script[] = {
+    {.reaction_time_us = 250000, .travel_time_us = 120000, .target_error_mm = 0},
+    {.reaction_time_us = 310000, .travel_time_us = 150000, .target_error_mm = 25},
+    {.reaction_time_us = 220000, .travel_time_us = 100000, .target_error_mm = -40},
+    {.reaction_time_us = 400000, .travel_time_us = 200000, .target_error_mm = 80},
+    {.reaction_time_us = 280000, .travel_time_us = 90000, .target_error_mm = -10}
+};
+/* clang-format on */
+
+#define SENSOR_SIM_SCRIPT_STEPS (sizeof(g_static_sensor_sim_script) / sizeof(g_static_sensor_sim_script[0]))
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static uint16_t Sensor_Sim_Model_FinalDistance (const sSensorSimStep_t *step, const uint16_t target_distance);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static uint16_t Sensor_Sim_Model_FinalDistance (const sSensorSimStep_t *step, const uint16_t target_distance) {
+    int32_t final_distance = (int32_t) target_distance + step->target_error_mm;
+
+    // 0 is an invalid reading, the hand never gets closer than the first millimetre
+    if (final_distance < 1) {
+        final_distance = 1;
+    }
+
+    return (uint16_t) final_distance;
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+uint8_t Sensor_Sim_Model_GetStepCount (void) {
+    return SENSOR_SIM_SCRIPT_STEPS;
+}
+
+/// Depends only on its arguments and the accuracy kernel, so the model also builds on the host without the framework
+uint16_t Sensor_Sim_Model_GetDistance (const uint8_t step, const uint16_t target_distance, const uint32_t elapsed_us) {
+    if (step >= SENSOR_SIM_SCRIPT_STEPS) {
+        return SENSOR_SIM_CLEAR_DISTANCE_MM;
+    }
+
+    const sSensorSimStep_t *script_step = &g_static_sensor_sim_script[step];
+
+    // The hand comes in from the side of the strip, the beam along it only sees the hand once it stops over the strip
+    if (elapsed_us < (script_step->reaction_time_us + script_step->travel_time_us)) {
+        return SENSOR_SIM_CLEAR_DISTANCE_MM;
+    }
+
+    return Sensor_Sim_Model_FinalDistance(script_step, target_distance);
+}
+
+bool Sensor_Sim_Model_GetTrial (const uint8_t step, const uint16_t target_distance, sSensorSimTrial_t *trial) {
+    if ((step >= SENSOR_SIM_SCRIPT_STEPS) || (trial == NULL)) {
+        return false;
+    }
+
+    const sSensorSimStep_t *script_step = &g_static_sensor_sim_script[step];
+
+    trial->distance = Sensor_Sim_Model_FinalDistance(script_step, target_distance);
+    trial->reaction_time = script_step->reaction_time_us + script_step->travel_time_us;
+
+    // Scored by the same kernel as the game mode, so the check follows any change to the curve
+    if (trial->distance > target_distance) {
+        trial->accuracy = Accuracy_Score_Get(trial->distance - target_distance);
+    } else {
+        trial->accuracy = Accuracy_Score_Get(target_distance - trial->distance);
+    }
+
+    return true;
+}
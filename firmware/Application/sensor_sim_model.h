@@ -0,0 +1,42 @@
+#ifndef SOURCE_APP_SENSOR_SIM_MODEL_H_
+#define SOURCE_APP_SENSOR_SIM_MODEL_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/// VL53L0X reports 8190 mm when nothing is in range
+#define SENSOR_SIM_CLEAR_DISTANCE_MM 8190
+/// Registration waits for the next sample after the hand arrives, polling adds up to one wait period
+#define SENSOR_SIM_REACTION_TOLERANCE_US 50000
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/// What a correct measurement and scoring path reports for one scripted step
+typedef struct sSensorSimTrial {
+    uint16_t distance;
+    uint32_t reaction_time;
+    uint8_t accuracy;
+} sSensorSimTrial_t;
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+uint8_t Sensor_Sim_Model_GetStepCount (void);
+uint16_t Sensor_Sim_Model_GetDistance (const uint8_t step, const uint16_t target_distance, const uint32_t elapsed_us);
+bool Sensor_Sim_Model_GetTrial (const uint8_t step, const uint16_t target_distance, sSensorSimTrial_t *trial);
+
+#endif /* SOURCE_APP_SENSOR_SIM_MODEL_H_ */
@@ -0,0 +1,79 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "session_arena.h"
+#include <string.h>
+#include "debug_api.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_SESSION_ARENA
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_SESSION_ARENA
+CREATE_MODULE_NAME (SESSION_ARENA)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+void *Session_Arena_Alloc (sSessionArena_t *arena, const size_t size) {
+    if ((arena == NULL) || (arena->buffer == NULL) || (size == 0)) {
+        return NULL;
+    }
+
+    size_t block = SESSION_ARENA_BLOCK(size);
+
+    if (block > (arena->size - arena->used)) {
+        TRACE_ERR("Failed to alloc [%u] bytes: Session arena [%u/%u] used\n", (unsigned int) size, (unsigned int) arena->used, (unsigned int) arena->size);
+
+        return NULL;
+    }
+
+    void *memory = &arena->buffer[arena->used];
+
+    arena->used += block;
+
+    memset(memory, 0, block);
+
+    return memory;
+}
+
+void Session_Arena_Reset (sSessionArena_t *arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    arena->used = 0;
+
+    return;
+}
@@ -0,0 +1,40 @@
+#ifndef SOURCE_APP_SESSION_ARENA_H_
+#define SOURCE_APP_SESSION_ARENA_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+#define SESSION_ARENA_ALIGNMENT 8
+/// Arena footprint of one allocation, used by game modes to publish their compile time arena size
+#define SESSION_ARENA_BLOCK(size) (((size) + SESSION_ARENA_ALIGNMENT - 1) & ~((size_t) SESSION_ARENA_ALIGNMENT - 1))
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+typedef struct sSessionArena {
+    uint8_t *buffer;
+    size_t size;
+    size_t used;
+} sSessionArena_t;
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+void *Session_Arena_Alloc (sSessionArena_t *arena, const size_t size);
+void Session_Arena_Reset (sSessionArena_t *arena);
+
+#endif /* SOURCE_APP_SESSION_ARENA_H_ */
@@ -0,0 +1,182 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "session_stats.h"
+#include <stddef.h>
+#include <string.h>
+#include "debug_api.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_SESSION_STATS
+
+#define PERCENTILE_MAX 100
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_SESSION_STATS
+CREATE_MODULE_NAME (SESSION_STATS)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static uint32_t Session_Stats_Sqrt (uint64_t value);
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static uint32_t Session_Stats_Sqrt (uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+
+        bit >>= 2;
+    }
+
+    return (uint32_t) root;
+}
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Session_Stats_Init (sSessionStats_t *stats, const uint32_t bin_width) {
+    if ((stats == NULL) || (bin_width == 0)) {
+        TRACE_ERR("Failed to init session stats: Invalid parameters\n");
+
+        return false;
+    }
+
+    memset(stats, 0, sizeof(sSessionStats_t));
+
+    stats->min = UINT32_MAX;
+    stats->bin_width = bin_width;
+
+    return true;
+}
+
+void Session_Stats_Add (sSessionStats_t *stats, const uint32_t value) {
+    if ((stats == NULL) || (stats->bin_width == 0)) {
+        return;
+    }
+
+    stats->count++;
+
+    // Welford update, the mean keeps a few fractional bits so small deltas are not lost over long sessions
+    int64_t scaled_value = (int64_t) value << SESSION_STATS_FRACTION_BITS;
+    int64_t delta = scaled_value - stats->mean;
+
+    stats->mean += delta / (int64_t) stats->count;
+
+    int64_t deviation = (delta * (scaled_value - stats->mean)) >> (2 * SESSION_STATS_FRACTION_BITS);
+
+    // Both factors share a sign, only truncation can make the product negative
+    if (deviation > 0) {
+        stats->m2 += (uint64_t) deviation;
+    }
+
+    if (value < stats->min) {
+        stats->min = value;
+    }
+
+    if (value > stats->max) {
+        stats->max = value;
+    }
+
+    uint32_t bin = value / stats->bin_width;
+
+    if (bin >= SESSION_STATS_BINS) {
+        bin = SESSION_STATS_BINS - 1;
+    }
+
+    stats->histogram[bin]++;
+
+    return;
+}
+
+uint32_t Session_Stats_GetMean (const sSessionStats_t *stats) {
+    if ((stats == NULL) || (stats->count == 0)) {
+        return 0;
+    }
+
+    return (uint32_t) ((stats->mean + (1 << (SESSION_STATS_FRACTION_BITS - 1))) >> SESSION_STATS_FRACTION_BITS);
+}
+
+uint32_t Session_Stats_GetStdDev (const sSessionStats_t *stats) {
+    if ((stats == NULL) || (stats->count < 2)) {
+        return 0;
+    }
+
+    return Session_Stats_Sqrt(stats->m2 / (stats->count - 1));
+}
+
+uint32_t Session_Stats_GetPercentile (const sSessionStats_t *stats, const uint8_t percentile) {
+    if ((stats == NULL) || (stats->count == 0) || (percentile > PERCENTILE_MAX)) {
+        return 0;
+    }
+
+    // Nearest rank, then interpolated inside the bin that holds it
+    uint32_t rank = (((uint64_t) percentile * stats->count) + PERCENTILE_MAX - 1) / PERCENTILE_MAX;
+
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint32_t below = 0;
+    uint32_t bin = 0;
+
+    while ((below + stats->histogram[bin]) < rank) {
+        below += stats->histogram[bin];
+        bin++;
+    }
+
+    // Beyond the range the histogram only knows the largest sample
+    if (bin == (SESSION_STATS_BINS - 1)) {
+        return stats->max;
+    }
+
+    uint32_t value = (bin * stats->bin_width) + (uint32_t) (((uint64_t) (rank - below) * stats->bin_width) / stats->histogram[bin]);
+
+    if (value < stats->min) {
+        value = stats->min;
+    }
+
+    if (value > stats->max) {
+        value = stats->max;
+    }
+
+    return value;
+}
@@ -0,0 +1,49 @@
+#ifndef SOURCE_APP_SESSION_STATS_H_
+#define SOURCE_APP_SESSION_STATS_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/// Fractional bits kept in the running mean
+#define SESSION_STATS_FRACTION_BITS 4
+/// Percentile histogram bins, the last one collects everything beyond the range
+#define SESSION_STATS_BINS 128
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/* clang-format off */
+typedef struct sSessionStats {
+    uint32_t count;
+    int64_t mean;           // Value << SESSION_STATS_FRACTION_BITS
+    uint64_t m2;            // Sum of squared deviations from the mean
+    uint32_t min;
+    uint32_t max;
+    uint32_t bin_width;
+    uint32_t histogram[SESSION_STATS_BINS];
+} sSessionStats_t;
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Session_Stats_Init (sSessionStats_t *stats, const uint32_t bin_width);
+void Session_Stats_Add (sSessionStats_t *stats, const uint32_t value);
+uint32_t Session_Stats_GetMean (const sSessionStats_t *stats);
+uint32_t Session_Stats_GetStdDev (const sSessionStats_t *stats);
+uint32_t Session_Stats_GetPercentile (const sSessionStats_t *stats, const uint8_t percentile);
+
+#endif /* SOURCE_APP_SESSION_STATS_H_ */
@@ -0,0 +1,88 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "timestamp.h"
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_tim.h"
+#include "framework_config.h"
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define TIMESTAMP_FREQUENCY_HZ 1000000UL
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static bool g_is_initialized = false;
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Timestamp_Init (void) {
+    if (g_is_initialized) {
+        return true;
+    }
+
+    LL_TIM_InitTypeDef timer_init = {0};
+
+    LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_TIM5);
+
+    // APB1 runs at SYSCLK / 2, so its timer clock is doubled back to SYSCLK
+    timer_init.Prescaler = (SYSTEM_CLOCK_HZ / TIMESTAMP_FREQUENCY_HZ) - 1;
+    timer_init.CounterMode = LL_TIM_COUNTERMODE_UP;
+    timer_init.Autoreload = UINT32_MAX;
+    timer_init.ClockDivision = LL_TIM_CLOCKDIVISION_DIV1;
+
+    if (LL_TIM_Init(TIMESTAMP_TIMER, &timer_init) != SUCCESS) {
+        return false;
+    }
+
+    LL_TIM_DisableARRPreload(TIMESTAMP_TIMER);
+    LL_TIM_EnableCounter(TIMESTAMP_TIMER);
+
+    // DWT cycle counter for benchmarking short code paths
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    g_is_initialized = true;
+
+    return true;
+}
+
+uint32_t Timestamp_GetUs (void) {
+    return LL_TIM_GetCounter(TIMESTAMP_TIMER);
+}
+
+uint32_t Timestamp_GetCycles (void) {
+    return DWT->CYCCNT;
+}
+
+uint32_t Timestamp_ElapsedUs (const uint32_t start, const uint32_t end) {
+    return end - start;
+}
@@ -0,0 +1,35 @@
+#ifndef SOURCE_APP_TIMESTAMP_H_
+#define SOURCE_APP_TIMESTAMP_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/// Free-running 32-bit timer, wraps after ~71 min at 1 MHz
+#define TIMESTAMP_TIMER TIM5
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Timestamp_Init (void);
+uint32_t Timestamp_GetUs (void);
+uint32_t Timestamp_GetCycles (void);
+uint32_t Timestamp_ElapsedUs (const uint32_t start, const uint32_t end);
+
+#endif /* SOURCE_APP_TIMESTAMP_H_ */
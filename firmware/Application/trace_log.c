@@ -0,0 +1,306 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "trace_log.h"
+
+#ifdef ENABLE_DEBUG
+
+#include <stddef.h>
+#include "cmsis_os.h"
+#include "debug_api.h"
+#ifdef ENABLE_TRACE_LOG
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_dma.h"
+#include "stm32f4xx_ll_usart.h"
+#include "usart.h"
+#endif
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_TRACE_LOG
+
+#ifdef ENABLE_TRACE_LOG
+#ifdef USE_UART_UROS_TX
+#error "ENABLE_TRACE_LOG sends its records on USART1, which USE_UART_UROS_TX already uses"
+#endif
+
+/// Must be a power of two
+#define TRACE_LOG_RING_SIZE 32
+
+/// Records go out on USART1 TX (PA9) through DMA2 stream 7 channel 4, the debug console keeps USART2
+#define TRACE_LOG_UART USART1
+#define TRACE_LOG_DMA DMA2
+#define TRACE_LOG_DMA_STREAM LL_DMA_STREAM_7
+#define TRACE_LOG_DMA_CHANNEL LL_DMA_CHANNEL_4
+#define TRACE_LOG_DMA_IRQ DMA2_Stream7_IRQn
+/// Must stay numerically >= configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, the callback uses RTOS FromISR calls
+#define TRACE_LOG_IRQ_PRIORITY 6
+
+/// Record: sync byte, (id << 3) | argument count, then each argument as an LEB128 varint
+#define TRACE_LOG_SYNC 0xA5U
+#define TRACE_LOG_ARGS_BITS 3
+#define TRACE_LOG_VARINT_MAX_SIZE 5
+#define TRACE_LOG_RECORD_MAX_SIZE (2 + (TRACE_LOG_MAX_ARGS * TRACE_LOG_VARINT_MAX_SIZE))
+#define TRACE_LOG_TX_BUFFER_SIZE 128
+
+_Static_assert((TRACE_LOG_MAX_ARGS < (1 << TRACE_LOG_ARGS_BITS)) && (eTraceLogId_Last <= (256 >> TRACE_LOG_ARGS_BITS)), "Trace log record header cannot hold the IDs or the argument count");
+#endif
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+typedef struct sTraceLogRecord {
+    eTraceLogId_t id;
+    uint8_t args_count;
+    uint32_t args[TRACE_LOG_MAX_ARGS];
+} sTraceLogRecord_t;
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_TRACE_LOG
+CREATE_MODULE_NAME (TRACE_LOG)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/* clang-format off */
+#ifdef ENABLE_TRACE_LOG
+#define TRACE_LOG_FORMAT_TEXT(id, format) format "\0"
+
+/// Formats in ID order, kept in the ELF by the linker script (INFO section) but never loaded, Tools/trace_decode.py reads them
+__attribute__((section(".trace_fmt"), used)) static const char g_static_trace_log_formats[] = TRACE_LOG_FORMAT_LIST(TRACE_LOG_FORMAT_TEXT);
+#else
+#define TRACE_LOG_FORMAT_LUT(id, format) [eTraceLogId_##id] = format,
+
+static const char *g_static_trace_log_format_lut[eTraceLogId_Last] = {
+    TRACE_LOG_FORMAT_LIST(TRACE_LOG_FORMAT_LUT)
+};
+#endif
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static bool g_is_initialized = false;
+
+#ifdef ENABLE_TRACE_LOG
+/// Single producer (reaction test thread), single consumer (UI thread)
+static sTraceLogRecord_t g_trace_log_ring[TRACE_LOG_RING_SIZE];
+static volatile uint32_t g_trace_log_head = 0;
+static volatile uint32_t g_trace_log_tail = 0;
+static volatile uint32_t g_trace_log_dropped = 0;
+static uint32_t g_trace_log_reported_dropped = 0;
+
+static uint8_t g_trace_log_tx_buffer[TRACE_LOG_TX_BUFFER_SIZE];
+static volatile bool g_is_sending = false;
+static trace_log_callback_t g_callback = NULL;
+#endif
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+#ifdef ENABLE_TRACE_LOG
+static size_t Trace_Log_Encode (uint8_t *buffer, const sTraceLogRecord_t *record);
+static void Trace_Log_InitTransport (void);
+
+void DMA2_Stream7_IRQHandler (void);
+#endif
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+#ifdef ENABLE_TRACE_LOG
+static size_t Trace_Log_Encode (uint8_t *buffer, const sTraceLogRecord_t *record) {
+    size_t length = 0;
+
+    buffer[length++] = TRACE_LOG_SYNC;
+    buffer[length++] = (uint8_t) ((record->id << TRACE_LOG_ARGS_BITS) | record->args_count);
+
+    // Small values dominate (module index, millimetres, accuracy), most arguments take one or two bytes
+    for (uint8_t arg = 0; arg < record->args_count; arg++) {
+        uint32_t value = record->args[arg];
+
+        while (value >= 0x80U) {
+            buffer[length++] = (uint8_t) (value | 0x80U);
+            value >>= 7;
+        }
+
+        buffer[length++] = (uint8_t) value;
+    }
+
+    return length;
+}
+
+static void Trace_Log_InitTransport (void) {
+    MX_USART1_UART_Init();
+
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2);
+
+    LL_DMA_DisableStream(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM);
+    LL_DMA_SetChannelSelection(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, TRACE_LOG_DMA_CHANNEL);
+    LL_DMA_SetDataTransferDirection(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+    LL_DMA_SetStreamPriorityLevel(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, LL_DMA_PRIORITY_LOW);
+    LL_DMA_SetMode(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, LL_DMA_MODE_NORMAL);
+    LL_DMA_SetPeriphIncMode(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, LL_DMA_PERIPH_NOINCREMENT);
+    LL_DMA_SetMemoryIncMode(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetPeriphSize(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, LL_DMA_PDATAALIGN_BYTE);
+    LL_DMA_SetMemorySize(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, LL_DMA_MDATAALIGN_BYTE);
+    LL_DMA_DisableFifoMode(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM);
+    LL_DMA_SetPeriphAddress(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, LL_USART_DMA_GetRegAddr(TRACE_LOG_UART));
+    LL_DMA_SetMemoryAddress(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, (uint32_t) g_trace_log_tx_buffer);
+    LL_DMA_EnableIT_TC(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM);
+
+    LL_USART_EnableDMAReq_TX(TRACE_LOG_UART);
+
+    NVIC_SetPriority(TRACE_LOG_DMA_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), TRACE_LOG_IRQ_PRIORITY, 0));
+    NVIC_EnableIRQ(TRACE_LOG_DMA_IRQ);
+
+    return;
+}
+
+void DMA2_Stream7_IRQHandler (void) {
+    if (!LL_DMA_IsActiveFlag_TC7(TRACE_LOG_DMA)) {
+        return;
+    }
+
+    LL_DMA_ClearFlag_TC7(TRACE_LOG_DMA);
+
+    g_is_sending = false;
+
+    // Records that came in during the transfer were left in the ring for the next one
+    if ((g_trace_log_tail != g_trace_log_head) && (g_callback != NULL)) {
+        g_callback();
+    }
+}
+#endif
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Trace_Log_Init (void) {
+    if (g_is_initialized) {
+        return true;
+    }
+
+#ifdef ENABLE_TRACE_LOG
+    Trace_Log_InitTransport();
+#endif
+
+    g_is_initialized = true;
+
+    return true;
+}
+
+bool Trace_Log_Put (const eTraceLogId_t id, const uint32_t *args, const uint8_t args_count) {
+    if (!g_is_initialized || (id < eTraceLogId_First) || (id >= eTraceLogId_Last) || (args_count > TRACE_LOG_MAX_ARGS)) {
+        return false;
+    }
+
+#ifdef ENABLE_TRACE_LOG
+    uint32_t head = g_trace_log_head;
+
+    if ((head - g_trace_log_tail) >= TRACE_LOG_RING_SIZE) {
+        g_trace_log_dropped++;
+
+        return false;
+    }
+
+    sTraceLogRecord_t *record = &g_trace_log_ring[head & (TRACE_LOG_RING_SIZE - 1)];
+
+    record->id = id;
+    record->args_count = args_count;
+
+    for (uint8_t arg = 0; arg < args_count; arg++) {
+        record->args[arg] = args[arg];
+    }
+
+    __DMB();
+    g_trace_log_head = head + 1;
+
+    if (g_callback != NULL) {
+        g_callback();
+    }
+#else
+    uint32_t record_args[TRACE_LOG_MAX_ARGS] = {0};
+
+    for (uint8_t arg = 0; arg < args_count; arg++) {
+        record_args[arg] = args[arg];
+    }
+
+    TRACE_INFO(g_static_trace_log_format_lut[id], record_args[0], record_args[1], record_args[2], record_args[3], record_args[4]);
+#endif
+
+    return true;
+}
+
+#ifdef ENABLE_TRACE_LOG
+/// The callback runs on every new record and when a transfer ends with records left, it must only signal the consumer
+bool Trace_Log_Attach (trace_log_callback_t callback) {
+    if (!g_is_initialized || (callback == NULL)) {
+        return false;
+    }
+
+    g_callback = callback;
+
+    return true;
+}
+
+/// Packs pending records into the transmit buffer and starts the DMA, runs on the UI thread
+void Trace_Log_Drain (void) {
+    if (!g_is_initialized) {
+        return;
+    }
+
+    if (g_trace_log_dropped != g_trace_log_reported_dropped) {
+        g_trace_log_reported_dropped = g_trace_log_dropped;
+
+        TRACE_WRN("Trace log dropped %lu records\n", g_trace_log_reported_dropped);
+    }
+
+    // The buffer belongs to the DMA until the transfer completes
+    if (g_is_sending) {
+        return;
+    }
+
+    size_t length = 0;
+
+    while ((g_trace_log_tail != g_trace_log_head) && ((length + TRACE_LOG_RECORD_MAX_SIZE) <= TRACE_LOG_TX_BUFFER_SIZE)) {
+        length += Trace_Log_Encode(&g_trace_log_tx_buffer[length], &g_trace_log_ring[g_trace_log_tail & (TRACE_LOG_RING_SIZE - 1)]);
+
+        __DMB();
+        g_trace_log_tail++;
+    }
+
+    if (length == 0) {
+        return;
+    }
+
+    g_is_sending = true;
+
+    LL_DMA_ClearFlag_TC7(TRACE_LOG_DMA);
+    LL_DMA_ClearFlag_HT7(TRACE_LOG_DMA);
+    LL_DMA_ClearFlag_TE7(TRACE_LOG_DMA);
+    LL_DMA_ClearFlag_DME7(TRACE_LOG_DMA);
+    LL_DMA_ClearFlag_FE7(TRACE_LOG_DMA);
+    LL_DMA_SetDataLength(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM, length);
+    LL_DMA_EnableStream(TRACE_LOG_DMA, TRACE_LOG_DMA_STREAM);
+
+    return;
+}
+#endif
+
+#endif /* ENABLE_DEBUG */
@@ -0,0 +1,65 @@
+#ifndef SOURCE_APP_TRACE_LOG_H_
+#define SOURCE_APP_TRACE_LOG_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "framework_config.h"
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+#define TRACE_LOG_MAX_ARGS 5
+
+/// X(id, format), formats take up to TRACE_LOG_MAX_ARGS uint32_t arguments
+/* clang-format off */
+#define TRACE_LOG_FORMAT_LIST(X)                                                    \
+    X(Distance, "Module [%lu] distance: [%lu]\n")                                   \
+    X(Attempt, "Time: %lu.%03lu ms, Target: %lu mm, Reg: %lu mm, Acc: %lu\n")       \
+    X(CueLatency, "Module [%lu] cue latency: [%lu] us\n")
+/* clang-format on */
+
+#ifdef ENABLE_DEBUG
+/// Logs a format ID and up to TRACE_LOG_MAX_ARGS uint32_t arguments, with ENABLE_TRACE_LOG they leave as binary records
+#define TRACE_LOG(id, ...) Trace_Log_Put((id), (const uint32_t[]) {__VA_ARGS__}, sizeof((const uint32_t[]) {__VA_ARGS__}) / sizeof(uint32_t))
+#else
+#define TRACE_LOG(id, ...)
+#endif
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+/* clang-format off */
+#define TRACE_LOG_ID_ENUM(id, format) eTraceLogId_##id,
+
+typedef enum eTraceLogId {
+    TRACE_LOG_FORMAT_LIST(TRACE_LOG_ID_ENUM)
+    eTraceLogId_Last,
+    eTraceLogId_First = 0
+} eTraceLogId_t;
+/* clang-format on */
+
+typedef void (*trace_log_callback_t) (void);
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+#ifdef ENABLE_DEBUG
+bool Trace_Log_Init (void);
+bool Trace_Log_Put (const eTraceLogId_t id, const uint32_t *args, const uint8_t args_count);
+#ifdef ENABLE_TRACE_LOG
+bool Trace_Log_Attach (trace_log_callback_t callback);
+void Trace_Log_Drain (void);
+#endif
+#endif
+
+#endif /* SOURCE_APP_TRACE_LOG_H_ */
@@ -0,0 +1,344 @@
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include "ui_task.h"
+#include <stddef.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "debug_api.h"
+#include "lcd_shadow.h"
+#include "trace_log.h"
+#ifdef ENABLE_BENCHMARK
+#include "timestamp.h"
+#endif
+
+/**********************************************************************************************************************
+ * Private definitions and macros
+ *********************************************************************************************************************/
+
+#define DEBUG_UI_TASK
+
+/// The low bits are left to the framework IO driver, which sets its triggered events on the same flags
+#define UI_TASK_IO_FLAGS 0x0FFU
+#define UI_TASK_LCD_FLAG 0x100U
+#define UI_TASK_UART_FLAG 0x200U
+#define UI_TASK_TRACE_FLAG 0x400U
+#define UI_TASK_ALL_FLAGS (UI_TASK_IO_FLAGS | UI_TASK_LCD_FLAG | UI_TASK_UART_FLAG | UI_TASK_TRACE_FLAG)
+
+/// Holds the three summary lines of a session and a game error line
+#define UI_TASK_UART_QUEUE_SIZE 4
+/// Posting never waits, a line that finds the queue full is dropped and counted
+#define UI_TASK_POST_TIMEOUT 0U
+
+/**********************************************************************************************************************
+ * Private typedef
+ *********************************************************************************************************************/
+
+typedef struct sUiTaskLine {
+    uint8_t size;
+    char text[UI_TASK_TEXT_CAPACITY];
+} sUiTaskLine_t;
+
+/**********************************************************************************************************************
+ * Private constants
+ *********************************************************************************************************************/
+
+#ifdef DEBUG_UI_TASK
+CREATE_MODULE_NAME (UI_TASK)
+#else
+CREATE_MODULE_NAME_EMPTY
+#endif
+
+/* clang-format off */
+const static osEventFlagsAttr_t g_ui_task_event_attributes = {
+    .name = "Ui_Task_Event",
+    .attr_bits = 0,
+    .cb_mem = NULL,
+    .cb_size = 0
+};
+
+const static osThreadAttr_t g_ui_task_thread_attributes = {
+    .name = "Ui_Task_Thread",
+    .stack_size = 256 * 4,
+    .priority = (osPriority_t) osPriorityLow
+};
+
+const static osMessageQueueAttr_t g_ui_task_queue_attributes = {
+    .name = "Ui_Task_Queue",
+    .attr_bits = 0,
+    .cb_mem = NULL,
+    .cb_size = 0,
+    .mq_mem = NULL,
+    .mq_size = 0
+};
+/* clang-format on */
+
+/**********************************************************************************************************************
+ * Private variables
+ *********************************************************************************************************************/
+
+static bool g_is_initialized = false;
+static osThreadId_t g_ui_task_thread_id = NULL;
+static osMessageQueueId_t g_ui_task_queue = NULL;
+static osEventFlagsId_t g_ui_task_event = NULL;
+
+static uint32_t g_button_event = 0;
+static ui_task_button_callback_t g_button_callback = NULL;
+
+static volatile uint32_t g_dropped_lines = 0;
+static uint32_t g_reported_dropped_lines = 0;
+
+#ifdef ENABLE_BENCHMARK
+/// Time the UI thread spent on LCD and UART output, what the game thread paid before it was deferred
+static volatile uint32_t g_output_time_us = 0;
+/// Time callers spent posting, what the game thread pays now
+static uint32_t g_post_time_us = 0;
+static uint32_t g_max_post_time_us = 0;
+static uint32_t g_posts = 0;
+#endif
+
+/**********************************************************************************************************************
+ * Exported variables and references
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of private functions
+ *********************************************************************************************************************/
+
+static void Ui_Task_Thread (void *arg);
+static void Ui_Task_LcdChanged (void);
+#if defined(ENABLE_DEBUG) && defined(ENABLE_TRACE_LOG)
+static void Ui_Task_TracePending (void);
+#endif
+#ifdef ENABLE_BENCHMARK
+static void Ui_Task_CountPost (const uint32_t start_time);
+#endif
+
+/**********************************************************************************************************************
+ * Definitions of private functions
+ *********************************************************************************************************************/
+
+static void Ui_Task_Thread (void *arg) {
+    sUiTaskLine_t line;
+
+    while (1) {
+        uint32_t flags = osEventFlagsWait(g_ui_task_event, UI_TASK_ALL_FLAGS, osFlagsWaitAny, osWaitForever);
+
+        if ((flags & osFlagsError) != 0) {
+            continue;
+        }
+
+#if defined(ENABLE_DEBUG) && defined(ENABLE_TRACE_LOG)
+        if ((flags & UI_TASK_TRACE_FLAG) != 0) {
+            Trace_Log_Drain();
+        }
+#endif
+
+        // Button presses are forwarded before any output, a slow LCD flush must not hold up START
+        if (((flags & g_button_event) != 0) && (g_button_callback != NULL)) {
+            g_button_callback();
+        }
+
+#ifdef ENABLE_BENCHMARK
+        uint32_t start_time = Timestamp_GetUs();
+#endif
+
+        if ((flags & UI_TASK_LCD_FLAG) != 0) {
+            Lcd_Shadow_Flush();
+        }
+
+        while (osMessageQueueGet(g_ui_task_queue, &line, NULL, 0U) == osOK) {
+            TRACE_INFO("%s", line.text);
+        }
+
+        // Callers never wait on a full queue, the loss is reported from here instead
+        if (g_dropped_lines != g_reported_dropped_lines) {
+            g_reported_dropped_lines = g_dropped_lines;
+
+            TRACE_WRN("UART output dropped %lu lines\n", g_reported_dropped_lines);
+        }
+
+#ifdef ENABLE_BENCHMARK
+        g_output_time_us += Timestamp_ElapsedUs(start_time, Timestamp_GetUs());
+#endif
+    }
+}
+
+static void Ui_Task_LcdChanged (void) {
+    osEventFlagsSet(g_ui_task_event, UI_TASK_LCD_FLAG);
+
+    return;
+}
+
+#if defined(ENABLE_DEBUG) && defined(ENABLE_TRACE_LOG)
+/// Also called from the trace DMA interrupt
+static void Ui_Task_TracePending (void) {
+    osEventFlagsSet(g_ui_task_event, UI_TASK_TRACE_FLAG);
+
+    return;
+}
+#endif
+
+#ifdef ENABLE_BENCHMARK
+static void Ui_Task_CountPost (const uint32_t start_time) {
+    uint32_t post_time = Timestamp_ElapsedUs(start_time, Timestamp_GetUs());
+
+    g_post_time_us += post_time;
+    g_posts++;
+
+    if (post_time > g_max_post_time_us) {
+        g_max_post_time_us = post_time;
+    }
+
+    return;
+}
+#endif
+
+/**********************************************************************************************************************
+ * Definitions of exported functions
+ *********************************************************************************************************************/
+
+bool Ui_Task_Init (void) {
+    if (g_is_initialized) {
+        return true;
+    }
+
+    g_ui_task_event = osEventFlagsNew(&g_ui_task_event_attributes);
+
+    if (g_ui_task_event == NULL) {
+        TRACE_ERR("Failed to create UI task event\n");
+
+        return false;
+    }
+
+    g_ui_task_queue = osMessageQueueNew(UI_TASK_UART_QUEUE_SIZE, sizeof(sUiTaskLine_t), &g_ui_task_queue_attributes);
+
+    if (g_ui_task_queue == NULL) {
+        TRACE_ERR("Failed to create UI task queue\n");
+
+        return false;
+    }
+
+    g_ui_task_thread_id = osThreadNew(Ui_Task_Thread, NULL, &g_ui_task_thread_attributes);
+
+    if (g_ui_task_thread_id == NULL) {
+        TRACE_ERR("Failed to create UI task thread\n");
+
+        return false;
+    }
+
+#if defined(ENABLE_DEBUG) && defined(ENABLE_TRACE_LOG)
+    if (!Trace_Log_Attach(Ui_Task_TracePending)) {
+        TRACE_ERR("Failed to attach trace log\n");
+
+        return false;
+    }
+#endif
+
+    g_is_initialized = true;
+
+    return true;
+}
+
+/// The LCD must already be initialized, from here on the UI thread is the only one writing it
+bool Ui_Task_AttachLcd (const eLcd_t lcd) {
+    if (!g_is_initialized) {
+        return false;
+    }
+
+    return Lcd_Shadow_Init(lcd, Ui_Task_LcdChanged);
+}
+
+/// The IO driver sets the event on the UI task flags, the callback then runs on the UI thread
+bool Ui_Task_AttachButton (const eIo_t io, const uint32_t event, ui_task_button_callback_t callback) {
+    if (!g_is_initialized || (callback == NULL) || (event == 0) || ((event & ~UI_TASK_IO_FLAGS) != 0)) {
+        return false;
+    }
+
+    g_button_callback = callback;
+    g_button_event = event;
+
+    return IO_API_Init(io, g_ui_task_event);
+}
+
+bool Ui_Task_PrintLcd (const sMessage_t *message, const eLcdRow_t row, const eLcdColumn_t column) {
+    if (!g_is_initialized) {
+        return false;
+    }
+
+#ifdef ENABLE_BENCHMARK
+    uint32_t start_time = Timestamp_GetUs();
+#endif
+
+    bool is_printed = Lcd_Shadow_Print(message, row, column);
+
+#ifdef ENABLE_BENCHMARK
+    Ui_Task_CountPost(start_time);
+#endif
+
+    return is_printed;
+}
+
+bool Ui_Task_ClearLcd (void) {
+    if (!g_is_initialized) {
+        return false;
+    }
+
+#ifdef ENABLE_BENCHMARK
+    uint32_t start_time = Timestamp_GetUs();
+#endif
+
+    bool is_cleared = Lcd_Shadow_Clear();
+
+#ifdef ENABLE_BENCHMARK
+    Ui_Task_CountPost(start_time);
+#endif
+
+    return is_cleared;
+}
+
+/// UART messages are null-terminated text, their size field is not used
+bool Ui_Task_PrintUart (const sMessage_t *message) {
+    if (!g_is_initialized || (message == NULL) || (message->data == NULL)) {
+        return false;
+    }
+
+#ifdef ENABLE_BENCHMARK
+    uint32_t start_time = Timestamp_GetUs();
+#endif
+
+    sUiTaskLine_t line;
+
+    line.size = strnlen(message->data, UI_TASK_TEXT_CAPACITY - 1);
+    memcpy(line.text, message->data, line.size);
+    line.text[line.size] = '\0';
+
+    bool is_posted = (osMessageQueuePut(g_ui_task_queue, &line, 0U, UI_TASK_POST_TIMEOUT) == osOK);
+
+    if (is_posted) {
+        osEventFlagsSet(g_ui_task_event, UI_TASK_UART_FLAG);
+    } else {
+        g_dropped_lines++;
+    }
+
+#ifdef ENABLE_BENCHMARK
+    Ui_Task_CountPost(start_time);
+#endif
+
+    return is_posted;
+}
+
+#ifdef ENABLE_BENCHMARK
+/// Reports and restarts the caller and output times, called once per trial
+void Ui_Task_BenchmarkReport (void) {
+    TRACE_INFO("UI: %lu posts blocked callers %lu us (max %lu us), output took %lu us, %lu lines dropped, %lu B stack unused\n", g_posts, g_post_time_us, g_max_post_time_us, g_output_time_us, g_dropped_lines, osThreadGetStackSpace(g_ui_task_thread_id));
+
+    g_posts = 0;
+    g_post_time_us = 0;
+    g_max_post_time_us = 0;
+    g_output_time_us = 0;
+
+    return;
+}
+#endif
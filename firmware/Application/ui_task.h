@@ -0,0 +1,45 @@
+#ifndef SOURCE_APP_UI_TASK_H_
+#define SOURCE_APP_UI_TASK_H_
+/**********************************************************************************************************************
+ * Includes
+ *********************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "framework_config.h"
+#include "io_api.h"
+#include "lcd_api.h"
+#include "message.h"
+
+/**********************************************************************************************************************
+ * Exported definitions and macros
+ *********************************************************************************************************************/
+
+/// Longest UART line the UI task carries, longer text is cut
+#define UI_TASK_TEXT_CAPACITY 64
+
+/**********************************************************************************************************************
+ * Exported types
+ *********************************************************************************************************************/
+
+typedef void (*ui_task_button_callback_t) (void);
+
+/**********************************************************************************************************************
+ * Exported variables
+ *********************************************************************************************************************/
+
+/**********************************************************************************************************************
+ * Prototypes of exported functions
+ *********************************************************************************************************************/
+
+bool Ui_Task_Init (void);
+bool Ui_Task_AttachLcd (const eLcd_t lcd);
+bool Ui_Task_AttachButton (const eIo_t io, const uint32_t event, ui_task_button_callback_t callback);
+bool Ui_Task_PrintLcd (const sMessage_t *message, const eLcdRow_t row, const eLcdColumn_t column);
+bool Ui_Task_ClearLcd (void);
+bool Ui_Task_PrintUart (const sMessage_t *message);
+#ifdef ENABLE_BENCHMARK
+void Ui_Task_BenchmarkReport (void);
+#endif
+
+#endif /* SOURCE_APP_UI_TASK_H_ */
@@ -198,6 +198,48 @@ void DebugMon_Handler(void)
 //  /* USER CODE END EXTI1_IRQn 1 */
 //}
 
+/**
+  * @brief This function handles EXTI line2 interrupt.
+  * @note Defined in Application/sensor_exti.c
+  */
+//void EXTI2_IRQHandler(void)
+//{
+//  /* USER CODE BEGIN EXTI2_IRQn 0 */
+//
+//  /* USER CODE END EXTI2_IRQn 0 */
+//  if (LL_EXTI_IsActiveFlag_0_31(LL_EXTI_LINE_2) != RESET)
+//  {
+//    LL_EXTI_ClearFlag_0_31(LL_EXTI_LINE_2);
+//    /* USER CODE BEGIN LL_EXTI_LINE_2 */
+//
+//    /* USER CODE END LL_EXTI_LINE_2 */
+//  }
+//  /* USER CODE BEGIN EXTI2_IRQn 1 */
+//
+//  /* USER CODE END EXTI2_IRQn 1 */
+//}
+
+/**
+  * @brief This function handles EXTI line3 interrupt.
+  * @note Defined in Application/sensor_exti.c
+  */
+//void EXTI3_IRQHandler(void)
+//{
+//  /* USER CODE BEGIN EXTI3_IRQn 0 */
+//
+//  /* USER CODE END EXTI3_IRQn 0 */
+//  if (LL_EXTI_IsActiveFlag_0_31(LL_EXTI_LINE_3) != RESET)
+//  {
+//    LL_EXTI_ClearFlag_0_31(LL_EXTI_LINE_3);
+//    /* USER CODE BEGIN LL_EXTI_LINE_3 */
+//
+//    /* USER CODE END LL_EXTI_LINE_3 */
+//  }
+//  /* USER CODE BEGIN EXTI3_IRQn 1 */
+//
+//  /* USER CODE END EXTI3_IRQn 1 */
+//}
+
 /**
   * @brief This function handles TIM1 update interrupt and TIM10 global interrupt.
   */
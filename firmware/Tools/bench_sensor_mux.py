@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""Benchmark the sensor mux scheduler in Application/sensor_mux.c on the host.
+
+Usage:
+  bench_sensor_mux.py [--sensors N] [--channels N] [--budget-us N] [--bus-hz N] [--duration-ms N]
+
+Builds sensor_mux.c with the host compiler (CC, default cc) against a simulated TCA9548A and a set of VL53L0X sensors
+in continuous ranging. Every sensor has a new sample each timing budget, a sample not read before the next one is
+lost. Sensor n sits on channel n % channels, the layout where reading in module order switches before every read.
+
+Both orders go through Sensor_Mux_Select, which already skips a switch to the selected channel:
+  module order    pending sensors read by index, what the app did before the scheduler
+  batched         pending sensors ordered by Sensor_Mux_Schedule
+
+Bus time per transaction follows the I2C clock (100 kHz in ThirdParty/Core/Src/i2c.c), 9 bit times per byte:
+  channel switch  address + control byte
+  sensor read     result registers (address + index, address + 12 bytes) and interrupt clear (address + index + data)
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Application")
+SOURCE = os.path.join(ROOT, "sensor_mux.c")
+SWITCH_BYTES = 2
+READ_BYTES = 2 + 13 + 3
+BITS_PER_BYTE = 9
+
+HARNESS = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include "sensor_mux.h"
+
+static unsigned long g_time_us = 0;
+static unsigned long g_switch_us = 0;
+static uint8_t g_selected_channel = SENSOR_MUX_CHANNEL_NONE;
+
+static bool Bench_Select (const uint8_t channel) {
+    g_time_us += g_switch_us;
+    g_selected_channel = channel;
+
+    return true;
+}
+
+int main (int argc, char **argv) {
+    if (argc != 8) {
+        return 2;
+    }
+
+    uint8_t sensors = (uint8_t) atoi(argv[1]);
+    uint8_t channels = (uint8_t) atoi(argv[2]);
+    unsigned long budget_us = strtoul(argv[3], NULL, 10);
+    unsigned long read_us = strtoul(argv[5], NULL, 10);
+    unsigned long duration_us = strtoul(argv[6], NULL, 10);
+    int is_batched = atoi(argv[7]);
+    uint8_t sensor_channel[SENSOR_MUX_MAX_SENSORS];
+    unsigned long next_sample[SENSOR_MUX_MAX_SENSORS];
+    unsigned long samples = 0;
+    unsigned long lost = 0;
+    sSensorMux_t mux;
+
+    g_switch_us = strtoul(argv[4], NULL, 10);
+
+    for (uint8_t sensor = 0; sensor < sensors; sensor++) {
+        sensor_channel[sensor] = sensor % channels;
+        // Sensors free run, their samples land at unrelated points of the budget
+        next_sample[sensor] = (budget_us * sensor) / sensors;
+    }
+
+    if (!Sensor_Mux_Init(&mux, sensor_channel, sensors, Bench_Select)) {
+        return 2;
+    }
+
+    while (g_time_us < duration_us) {
+        uint32_t pending = 0;
+        unsigned long earliest = (unsigned long) -1;
+
+        for (uint8_t sensor = 0; sensor < sensors; sensor++) {
+            if (next_sample[sensor] <= g_time_us) {
+                pending |= 1UL << sensor;
+            } else if (next_sample[sensor] < earliest) {
+                earliest = next_sample[sensor];
+            }
+        }
+
+        if (pending == 0) {
+            g_time_us = earliest;
+
+            continue;
+        }
+
+        uint8_t order[SENSOR_MUX_MAX_SENSORS];
+        uint8_t count = 0;
+
+        if (is_batched) {
+            count = Sensor_Mux_Schedule(&mux, pending, order);
+        } else {
+            for (uint32_t remaining = pending; remaining != 0; remaining &= remaining - 1) {
+                order[count] = (uint8_t) __builtin_ctz(remaining);
+                count++;
+            }
+        }
+
+        for (uint8_t index = 0; index < count; index++) {
+            uint8_t sensor = order[index];
+
+            if (!Sensor_Mux_Select(&mux, sensor) || (g_selected_channel != sensor_channel[sensor])) {
+                return 3;
+            }
+
+            g_time_us += read_us;
+            samples++;
+
+            // The sensor kept ranging while the bus was busy, samples it replaced are gone
+            next_sample[sensor] += budget_us;
+
+            while (next_sample[sensor] + budget_us <= g_time_us) {
+                next_sample[sensor] += budget_us;
+                lost++;
+            }
+        }
+    }
+
+    printf("%lu %lu %lu %lu %lu\n", samples, lost, (unsigned long) mux.transactions, (unsigned long) mux.switches, g_time_us);
+
+    return 0;
+}
+"""
+
+
+def run(binary, arguments, switch_us, read_us, is_batched):
+    output = subprocess.check_output([binary, str(arguments.sensors), str(arguments.channels), str(arguments.budget_us), str(switch_us), str(read_us),
+                                      str(arguments.duration_ms * 1000), "1" if is_batched else "0"])
+    samples, lost, transactions, switches, elapsed_us = (int(value) for value in output.split())
+
+    return {"samples": samples, "lost": lost, "transactions": transactions, "switches": switches, "rate": (samples * 1000000) // elapsed_us}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--sensors", type=int, default=16)
+    parser.add_argument("--channels", type=int, default=8)
+    parser.add_argument("--budget-us", type=int, default=20000, help="VL53L0X timing budget, 20 ms in high speed mode")
+    parser.add_argument("--bus-hz", type=int, default=100000)
+    parser.add_argument("--duration-ms", type=int, default=1000)
+    arguments = parser.parse_args()
+
+    if not (1 <= arguments.sensors <= 32) or not (1 <= arguments.channels <= 8):
+        sys.exit("1..32 sensors on 1..8 channels")
+
+    bit_us = 1000000.0 / arguments.bus_hz
+    switch_us = int(round(SWITCH_BYTES * BITS_PER_BYTE * bit_us))
+    read_us = int(round(READ_BYTES * BITS_PER_BYTE * bit_us))
+    compiler = os.environ.get("CC", "cc")
+
+    with tempfile.TemporaryDirectory() as directory:
+        harness = os.path.join(directory, "sensor_mux_bench.c")
+        binary = os.path.join(directory, "sensor_mux_bench")
+
+        with open(harness, "w") as source:
+            source.write(HARNESS)
+
+        subprocess.check_call([compiler, "-std=c11", "-O2", "-Wall", "-Wextra", "-Werror", "-I", ROOT, harness, SOURCE, "-o", binary])
+
+        print("%d sensors on %d channels, %d us budget, %d Hz bus: switch %d us, read %d us, %d sensor limit %d samples/s"
+              % (arguments.sensors, arguments.channels, arguments.budget_us, arguments.bus_hz, switch_us, read_us, arguments.sensors,
+                 (arguments.sensors * 1000000) // arguments.budget_us))
+
+        for name, is_batched in (("module order", False), ("batched", True)):
+            result = run(binary, arguments, switch_us, read_us, is_batched)
+
+            print("  %-12s %6d samples/s, %6d lost, %6d switches for %6d transactions"
+                  % (name, result["rate"], result["lost"], result["switches"], result["transactions"]))
+
+
+if __name__ == "__main__":
+    main()
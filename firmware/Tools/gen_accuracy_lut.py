@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Generate and check the accuracy bound table in Application/accuracy_score.c.
+
+Usage:
+  gen_accuracy_lut.py            print the generated block
+  gen_accuracy_lut.py --write    replace the generated block in accuracy_score.c
+  gen_accuracy_lut.py --check    build accuracy_score.c with the host compiler (CC, default cc), score every error
+                                 in 0..ACCURACY_CHECK_RANGE_MM and compare with the double precision curve
+
+ACCURACY_MAX, ACCURACY_SIGMA and DEFAULT_DISTANCE_THRESHOLD_MM are read from accuracy_score.h. The block carries a
+_Static_assert on them, so the firmware stops building when they change and the table was not regenerated.
+"""
+
+import math
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Application")
+HEADER = os.path.join(ROOT, "accuracy_score.h")
+SOURCE = os.path.join(ROOT, "accuracy_score.c")
+BEGIN = "/* Begin generated, Tools/gen_accuracy_lut.py --write */\n"
+END = "/* End generated */\n"
+# Covers the longest configured strip (85 LEDs ~ 1417 mm)
+ACCURACY_CHECK_RANGE_MM = 2000
+COLUMNS = 10
+
+HARNESS = r"""
+#include <stdio.h>
+#include "accuracy_score.h"
+
+int main (void) {
+    for (unsigned int error = 0; error <= %d; error++) {
+        printf("%%u\n", Accuracy_Score_Get(error));
+    }
+
+    return 0;
+}
+"""
+
+
+def read_parameters():
+    with open(HEADER) as header:
+        text = header.read()
+
+    parameters = {}
+
+    for name in ("ACCURACY_MAX", "ACCURACY_SIGMA", "DEFAULT_DISTANCE_THRESHOLD_MM"):
+        match = re.search(r"^#define %s (\d+)" % name, text, re.M)
+
+        if match is None:
+            sys.exit("%s not found in %s" % (name, HEADER))
+
+        parameters[name] = int(match.group(1))
+
+    return parameters
+
+
+def reference(parameters, spacial_error):
+    threshold = parameters["DEFAULT_DISTANCE_THRESHOLD_MM"]
+
+    if spacial_error <= threshold:
+        return parameters["ACCURACY_MAX"]
+
+    excess_error = spacial_error - threshold
+    sigma = parameters["ACCURACY_SIGMA"]
+
+    return int(parameters["ACCURACY_MAX"] * math.exp(-(excess_error * excess_error) / (2.0 * sigma * sigma)))
+
+
+def build_bounds(parameters):
+    accuracy_max = parameters["ACCURACY_MAX"]
+    threshold = parameters["DEFAULT_DISTANCE_THRESHOLD_MM"]
+    bounds = [0xFFFFFFFF] + [0] * accuracy_max
+    excess_error = 0
+
+    # The curve only falls with error, so one pass finds where it drops below each score
+    for accuracy in range(accuracy_max, 0, -1):
+        while reference(parameters, threshold + excess_error) >= accuracy:
+            excess_error += 1
+
+        bounds[accuracy] = excess_error
+
+    return bounds
+
+
+def generate(parameters):
+    bounds = build_bounds(parameters)
+    lines = [BEGIN.rstrip("\n")]
+
+    lines.append("_Static_assert((ACCURACY_MAX == %d) && (ACCURACY_SIGMA == %d) && (DEFAULT_DISTANCE_THRESHOLD_MM == %d), \"Regenerate with Tools/gen_accuracy_lut.py --write\");"
+                 % (parameters["ACCURACY_MAX"], parameters["ACCURACY_SIGMA"], parameters["DEFAULT_DISTANCE_THRESHOLD_MM"]))
+    lines.append("")
+    lines.append("/// Entry a is the first error past the threshold (mm) that scores below a")
+    lines.append("static const uint32_t g_static_accuracy_bound_lut[ACCURACY_MAX + 1] = {")
+    lines.append("    UINT32_MAX,")
+
+    values = bounds[1:]
+
+    for row in range(0, len(values), COLUMNS):
+        lines.append("    " + ", ".join("%u" % value for value in values[row:row + COLUMNS]) + ",")
+
+    lines.append("};")
+    lines.append(END.rstrip("\n"))
+
+    return "\n".join(lines) + "\n"
+
+
+def write(parameters):
+    with open(SOURCE) as source:
+        text = source.read()
+
+    begin = text.find(BEGIN)
+    end = text.find(END)
+
+    if (begin < 0) or (end < begin):
+        sys.exit("Generated block markers not found in %s" % SOURCE)
+
+    with open(SOURCE, "w") as source:
+        source.write(text[:begin] + generate(parameters) + text[end + len(END):])
+
+
+def check(parameters):
+    compiler = os.environ.get("CC", "cc")
+
+    with tempfile.TemporaryDirectory() as directory:
+        harness = os.path.join(directory, "accuracy_check.c")
+        binary = os.path.join(directory, "accuracy_check")
+
+        with open(harness, "w") as source:
+            source.write(HARNESS % ACCURACY_CHECK_RANGE_MM)
+
+        subprocess.check_call([compiler, "-std=c11", "-Wall", "-Wextra", "-Werror", "-I", ROOT, harness, SOURCE, "-o", binary])
+        scores = [int(line) for line in subprocess.check_output([binary]).decode().split()]
+
+    mismatches = [error for error in range(ACCURACY_CHECK_RANGE_MM + 1) if scores[error] != reference(parameters, error)]
+
+    print("Accuracy 0..%d mm: %d mismatches" % (ACCURACY_CHECK_RANGE_MM, len(mismatches)))
+
+    for error in mismatches[:10]:
+        print("  %d mm: firmware %d, reference %d" % (error, scores[error], reference(parameters, error)))
+
+    return 1 if mismatches else 0
+
+
+def main():
+    parameters = read_parameters()
+
+    if "--check" in sys.argv[1:]:
+        sys.exit(check(parameters))
+
+    if "--write" in sys.argv[1:]:
+        write(parameters)
+
+        return
+
+    sys.stdout.write(generate(parameters))
+
+
+if __name__ == "__main__":
+    main()
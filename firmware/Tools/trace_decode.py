@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Decode binary trace log records sent on the trace UART (USART1 TX, PA9, 115200 8N1).
+
+Usage:
+  trace_decode.py luxio.elf [capture.bin | /dev/ttyUSBx]    reads stdin when no capture or device is given
+  e.g. stty -F /dev/ttyUSB0 115200 raw && trace_decode.py Debug/luxio.elf /dev/ttyUSB0
+
+The format strings are read from the .trace_fmt section of the firmware ELF, so the decoder always matches the
+image that produced the records. Record: 0xA5, (id << 3) | argument count, then each argument as an LEB128 varint.
+"""
+
+import os
+import re
+import struct
+import sys
+
+TRACE_LOG_SYNC = 0xA5
+TRACE_LOG_ARGS_BITS = 3
+TRACE_LOG_VARINT_MAX_SIZE = 5
+SECTION = ".trace_fmt"
+
+CONVERSION = re.compile(r"%([-+ #0]*\d*)(?:ll|l|hh|h)?([diuxX])")
+
+
+def read_formats(elf_path):
+    with open(elf_path, "rb") as elf:
+        image = elf.read()
+
+    if (image[:4] != b"\x7fELF") or (image[5] != 1):
+        sys.exit("%s is not a little-endian ELF" % elf_path)
+
+    # ELF32 for the target, ELF64 for host builds of the same sources
+    if image[4] == 1:
+        section_offset, = struct.unpack_from("<I", image, 0x20)
+        section_size, section_count, names_index = struct.unpack_from("<HHH", image, 0x2E)
+        section_format = "<IIIIII"
+    else:
+        section_offset, = struct.unpack_from("<Q", image, 0x28)
+        section_size, section_count, names_index = struct.unpack_from("<HHH", image, 0x3A)
+        section_format = "<IIQQQQ"
+
+    # (name, type, flags, address, offset, size)
+    def section(index):
+        return struct.unpack_from(section_format, image, section_offset + (index * section_size))
+
+    names = section(names_index)
+
+    for index in range(section_count):
+        header = section(index)
+        name_start = names[4] + header[0]
+        name = image[name_start:image.index(b"\0", name_start)].decode()
+
+        if name == SECTION:
+            blob = image[header[4]:header[4] + header[5]]
+            formats = []
+
+            for text in blob.split(b"\0"):
+                if not text:
+                    break
+
+                formats.append(text.decode())
+
+            return formats
+
+    sys.exit("%s has no %s section, build with ENABLE_TRACE_LOG" % (elf_path, SECTION))
+
+
+def to_python(text):
+    return CONVERSION.sub(lambda match: "%" + match.group(1) + ("d" if match.group(2) in "diu" else match.group(2)), text)
+
+
+def read_bytes(stream):
+    while True:
+        chunk = os.read(stream.fileno(), 256)
+
+        if not chunk:
+            return
+
+        for value in chunk:
+            yield value
+
+
+def decode(formats, stream, output):
+    python_formats = [to_python(text) for text in formats]
+    args_counts = [len(CONVERSION.findall(text)) for text in formats]
+    data = read_bytes(stream)
+
+    for value in data:
+        if value != TRACE_LOG_SYNC:
+            continue
+
+        header = next(data, None)
+
+        if header is None:
+            return
+
+        record_id = header >> TRACE_LOG_ARGS_BITS
+        args_count = header & ((1 << TRACE_LOG_ARGS_BITS) - 1)
+
+        # A sync byte inside a varint, look for the next one
+        if (record_id >= len(formats)) or (args_count != args_counts[record_id]):
+            continue
+
+        args = []
+
+        for _ in range(args_count):
+            argument = 0
+
+            for shift in range(0, 7 * TRACE_LOG_VARINT_MAX_SIZE, 7):
+                part = next(data, None)
+
+                if part is None:
+                    return
+
+                argument |= (part & 0x7F) << shift
+
+                if (part & 0x80) == 0:
+                    break
+
+            args.append(argument & 0xFFFFFFFF)
+
+        output.write(python_formats[record_id] % tuple(args))
+        output.flush()
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+
+    formats = read_formats(sys.argv[1])
+
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], "rb", buffering=0) as stream:
+            decode(formats, stream, sys.stdout)
+    else:
+        decode(formats, sys.stdin.buffer, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()